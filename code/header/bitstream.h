@@ -0,0 +1,37 @@
+// file: header/bitstream.h
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! Bitstream
+// !
+// =======================================================================//
+
+typedef struct librg_bitstream {
+    char *buffer;
+    size_t size;        /* size of the buffer in bytes */
+    size_t position;    /* current position in bits */
+} librg_bitstream;
+
+LIBRG_API int8_t librg_bitstream_init(LIBRG_OUT librg_bitstream *stream, char *buffer, size_t size);
+LIBRG_API int8_t librg_bitstream_from_event(librg_world *world, librg_event *event, LIBRG_OUT librg_bitstream *stream);
+LIBRG_API size_t librg_bitstream_size(librg_bitstream *stream);
+
+LIBRG_API int8_t librg_bitstream_write_bits(librg_bitstream *stream, uint64_t value, uint8_t bits);
+LIBRG_API int8_t librg_bitstream_read_bits(librg_bitstream *stream, LIBRG_OUT uint64_t *value, uint8_t bits);
+
+LIBRG_API int8_t librg_bitstream_write_int(librg_bitstream *stream, int64_t value, int64_t min, int64_t max);
+LIBRG_API int8_t librg_bitstream_read_int(librg_bitstream *stream, LIBRG_OUT int64_t *value, int64_t min, int64_t max);
+LIBRG_API int8_t librg_bitstream_write_float(librg_bitstream *stream, float value, float min, float max, float precision);
+LIBRG_API int8_t librg_bitstream_read_float(librg_bitstream *stream, LIBRG_OUT float *value, float min, float max, float precision);
+LIBRG_API int8_t librg_bitstream_write_quat(librg_bitstream *stream, const float *quat, uint8_t bits);
+LIBRG_API int8_t librg_bitstream_read_quat(librg_bitstream *stream, LIBRG_OUT float *quat, uint8_t bits);
+LIBRG_API int8_t librg_bitstream_write_delta(librg_bitstream *stream, int64_t value, int64_t previous, uint8_t small_bits, uint8_t bits);
+LIBRG_API int8_t librg_bitstream_read_delta(librg_bitstream *stream, LIBRG_OUT int64_t *value, int64_t previous, uint8_t small_bits, uint8_t bits);
+
+LIBRG_END_C_DECLS
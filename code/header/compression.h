@@ -0,0 +1,29 @@
+// file: header/compression.h
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! Compression
+// !
+// =======================================================================//
+
+typedef struct librg_compression_stats {
+    uint64_t frames;            /* amount of buffers passed through the compression stage */
+    uint64_t raw_bytes;         /* total size of the buffers before compression */
+    uint64_t compressed_bytes;  /* total size of the buffers after compression */
+    float    ratio;             /* compressed_bytes / raw_bytes */
+    double   compress_time;     /* total time spent compressing, in seconds */
+    double   decompress_time;   /* total time spent decompressing, in seconds */
+} librg_compression_stats;
+
+LIBRG_API int8_t  librg_world_compression_stats(librg_world *world, LIBRG_OUT librg_compression_stats *stats);
+LIBRG_API int32_t librg_compression_lz_encode(const char *input, size_t input_size, LIBRG_OUT char *output, size_t output_limit, const char *dictionary, size_t dictionary_size);
+LIBRG_API int32_t librg_compression_lz_decode(const char *input, size_t input_size, LIBRG_OUT char *output, size_t output_limit, const char *dictionary, size_t dictionary_size);
+LIBRG_API int32_t librg_compression_dictionary_train(const char **samples, const size_t *sample_sizes, size_t sample_amount, LIBRG_OUT char *dictionary, size_t dictionary_size);
+
+LIBRG_END_C_DECLS
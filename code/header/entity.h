@@ -14,6 +14,8 @@ LIBRG_BEGIN_C_DECLS
 
 LIBRG_API int8_t  librg_entity_track(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t  librg_entity_untrack(librg_world *world, int64_t entity_id);
+LIBRG_API int32_t librg_entity_track_many(librg_world *world, const int64_t *entity_ids, size_t amount);
+LIBRG_API int32_t librg_entity_untrack_many(librg_world *world, const int64_t *entity_ids, size_t amount);
 LIBRG_API int8_t  librg_entity_tracked(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t  librg_entity_foreign(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t  librg_entity_owned(librg_world *world, int64_t entity_id);
@@ -28,9 +30,11 @@ LIBRG_API int32_t librg_entity_count(librg_world *world);
 LIBRG_API int8_t        librg_entity_userdata_set(librg_world *world, int64_t entity_id, void *data);
 LIBRG_API void *        librg_entity_userdata_get(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t        librg_entity_chunk_set(librg_world *world, int64_t entity_id, librg_chunk);
+LIBRG_API int32_t       librg_entity_chunk_set_many(librg_world *world, const int64_t *entity_ids, const librg_chunk *chunks, size_t amount);
 LIBRG_API librg_chunk   librg_entity_chunk_get(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t        librg_entity_chunkarray_set(librg_world *world, int64_t entity_id, const librg_chunk *chunks, size_t chunk_amount);
 LIBRG_API int8_t        librg_entity_chunkarray_get(librg_world *world, int64_t entity_id, LIBRG_OUT librg_chunk *chunks, LIBRG_INOUT size_t *chunk_amount);
+LIBRG_API int8_t        librg_entity_aabb_set(librg_world *world, int64_t entity_id, const double *min, const double *max);
 LIBRG_API int8_t        librg_entity_dimension_set(librg_world *world, int64_t entity_id, int32_t dimension);
 LIBRG_API int32_t       librg_entity_dimension_get(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t        librg_entity_owner_set(librg_world *world, int64_t entity_id, int64_t owner_id);
@@ -39,6 +43,41 @@ LIBRG_API int8_t        librg_entity_visibility_global_set(librg_world *world, i
 LIBRG_API int8_t        librg_entity_visibility_global_get(librg_world *world, int64_t entity_id);
 LIBRG_API int8_t        librg_entity_visibility_owner_set(librg_world *world, int64_t entity_id, int64_t owner_id, librg_visibility value);
 LIBRG_API int8_t        librg_entity_visibility_owner_get(librg_world *world, int64_t entity_id, int64_t owner_id);
+LIBRG_API int8_t        librg_entity_layers_set(librg_world *world, int64_t entity_id, uint64_t layers);
+LIBRG_API int8_t        librg_entity_layers_get(librg_world *world, int64_t entity_id, LIBRG_OUT uint64_t *layers);
+LIBRG_API int8_t        librg_entity_visibility_range_set(librg_world *world, int64_t entity_id, uint8_t chunk_range);
+LIBRG_API int32_t       librg_entity_visibility_range_get(librg_world *world, int64_t entity_id);
+LIBRG_API int8_t        librg_entity_priority_set(librg_world *world, int64_t entity_id, float weight);
+LIBRG_API int8_t        librg_entity_priority_get(librg_world *world, int64_t entity_id, LIBRG_OUT float *weight);
+LIBRG_API int8_t        librg_entity_dirty_set(librg_world *world, int64_t entity_id);
+LIBRG_API int8_t        librg_entity_dirty_get(librg_world *world, int64_t entity_id, int64_t owner_id);
+
+// =======================================================================//
+// !
+// ! Entity attachments
+// !
+// =======================================================================//
+
+LIBRG_API int8_t        librg_entity_attach(librg_world *world, int64_t entity_id, int64_t parent_id);
+LIBRG_API int8_t        librg_entity_detach(librg_world *world, int64_t entity_id);
+LIBRG_API int64_t       librg_entity_parent_get(librg_world *world, int64_t entity_id);
+
+// =======================================================================//
+// !
+// ! Entity handles
+// !
+// =======================================================================//
+
+LIBRG_API librg_entity_handle librg_entity_handle_get(librg_world *world, int64_t entity_id);
+LIBRG_API int8_t        librg_entity_track_handle(librg_world *world, int64_t entity_id, LIBRG_OUT librg_entity_handle *handle);
+LIBRG_API int8_t        librg_entity_handle_valid(librg_world *world, librg_entity_handle handle);
+LIBRG_API int64_t       librg_entity_handle_id(librg_world *world, librg_entity_handle handle);
+LIBRG_API int8_t        librg_entity_handle_userdata_set(librg_world *world, librg_entity_handle handle, void *data);
+LIBRG_API void *        librg_entity_handle_userdata_get(librg_world *world, librg_entity_handle handle);
+LIBRG_API int8_t        librg_entity_handle_chunk_set(librg_world *world, librg_entity_handle handle, librg_chunk chunk);
+LIBRG_API librg_chunk   librg_entity_handle_chunk_get(librg_world *world, librg_entity_handle handle);
+LIBRG_API int64_t       librg_entity_handle_owner_get(librg_world *world, librg_entity_handle handle);
+LIBRG_API int8_t        librg_entity_handle_dirty_set(librg_world *world, librg_entity_handle handle);
 
 /* deprecated since 7.0 */
 LIBRG_API int8_t        librg_entity_radius_set(librg_world *world, int64_t entity_id, int8_t observed_chunk_radius);
@@ -12,13 +12,40 @@ LIBRG_BEGIN_C_DECLS
 // !
 // =======================================================================//
 
+typedef struct librg_memory_usage {
+    uint64_t bytes;             /* memory currently allocated for the structure */
+    uint64_t count;             /* amount of elements currently stored */
+    uint64_t sampled_max_bytes; /* highest value of bytes observed by librg_world_memory_stats */
+    uint64_t sampled_max_count; /* highest value of count observed by librg_world_memory_stats */
+} librg_memory_usage;
+
+typedef struct librg_memory_stats {
+    librg_memory_usage entities;    /* entity storage and attachment lists, counted in entities */
+    librg_memory_usage handles;     /* entity handle slots, counted in slots */
+    librg_memory_usage visibility;  /* owner visibility overrides, that did not fit inline, counted in overrides */
+    librg_memory_usage pairs;       /* owner-entity pairs, counted in pairs */
+    librg_memory_usage query;       /* query indices and owner interests, counted in indexed entities */
+    librg_memory_usage owners;      /* owner storage, priorities and sent epochs, counted in owners */
+    librg_memory_usage snapshots;   /* per-owner snapshots, including spare and unacknowledged ones, counted in entries */
+    librg_memory_usage baselines;   /* delta encoding baselines of both writers and readers, counted in baselines */
+    librg_memory_usage buffers;     /* scratch buffers, caches and pooled blocks, counted in bytes used */
+    librg_memory_usage largest_snapshot; /* snapshot of a single owner with the most entries */
+    librg_memory_usage total;       /* all of the above, and the world itself */
+} librg_memory_stats;
+
 LIBRG_API uint32_t      librg_version();
 LIBRG_API librg_world * librg_world_create();
+LIBRG_API librg_world * librg_world_create_ex(const librg_allocator *allocator);
 LIBRG_API int8_t        librg_world_destroy(librg_world *world);
 LIBRG_API int8_t        librg_world_valid(librg_world *world);
 LIBRG_API int8_t        librg_world_userdata_set(librg_world *world, void *data);
 LIBRG_API void *        librg_world_userdata_get(librg_world *world);
 LIBRG_API int64_t       librg_world_entities_tracked(librg_world *world);
+LIBRG_API int8_t        librg_world_tick(librg_world *world);
+LIBRG_API int8_t        librg_world_interest_set(librg_world *world, int64_t owner_id, uint64_t layers);
+LIBRG_API uint64_t      librg_world_interest_get(librg_world *world, int64_t owner_id);
+LIBRG_API int8_t        librg_world_reserve(librg_world *world, size_t entities, size_t owners, size_t entities_per_owner);
+LIBRG_API int8_t        librg_world_memory_stats(librg_world *world, LIBRG_OUT librg_memory_stats *stats);
 
 // =======================================================================//
 // !
@@ -32,6 +59,20 @@ LIBRG_API int8_t librg_config_chunksize_set(librg_world *world, uint16_t x, uint
 LIBRG_API int8_t librg_config_chunksize_get(librg_world *world, uint16_t *x, uint16_t *y, uint16_t *z);
 LIBRG_API int8_t librg_config_chunkoffset_set(librg_world *world, int16_t x, int16_t y, int16_t z);
 LIBRG_API int8_t librg_config_chunkoffset_get(librg_world *world, int16_t *x, int16_t *y, int16_t *z);
+LIBRG_API int8_t librg_config_deltaencoding_set(librg_world *world, uint8_t value);
+LIBRG_API int8_t librg_config_deltaencoding_get(librg_world *world);
+LIBRG_API int8_t librg_config_prioritization_set(librg_world *world, uint8_t value);
+LIBRG_API int8_t librg_config_prioritization_get(librg_world *world);
+LIBRG_API int8_t librg_config_dirtytracking_set(librg_world *world, uint8_t value);
+LIBRG_API int8_t librg_config_dirtytracking_get(librg_world *world);
+LIBRG_API int8_t librg_config_acknowledgement_set(librg_world *world, uint8_t value);
+LIBRG_API int8_t librg_config_acknowledgement_get(librg_world *world);
+LIBRG_API int8_t librg_config_wireformat_set(librg_world *world, librg_wireformat value);
+LIBRG_API int8_t librg_config_wireformat_get(librg_world *world);
+LIBRG_API int8_t librg_config_compression_set(librg_world *world, uint8_t value);
+LIBRG_API int8_t librg_config_compression_get(librg_world *world);
+LIBRG_API int8_t librg_config_compression_codec_set(librg_world *world, librg_codec_fn encode, librg_codec_fn decode);
+LIBRG_API int8_t librg_config_compression_dictionary_set(librg_world *world, const char *dictionary, size_t size);
 
 // =======================================================================//
 // !
@@ -41,6 +82,10 @@ LIBRG_API int8_t librg_config_chunkoffset_get(librg_world *world, int16_t *x, in
 
 LIBRG_API int8_t  librg_event_set(librg_world *world, librg_event_type, librg_event_fn);
 LIBRG_API int8_t  librg_event_remove(librg_world *world, librg_event_type);
+LIBRG_API int8_t  librg_event_batch_set(librg_world *world, librg_event_type, librg_event_batch_fn, size_t slot_size);
+LIBRG_API int8_t  librg_event_batch_remove(librg_world *world, librg_event_type);
+LIBRG_API int8_t  librg_event_cache_set(librg_world *world, librg_event_type, uint8_t value);
+LIBRG_API int8_t  librg_event_cache_get(librg_world *world, librg_event_type);
 
 LIBRG_API int8_t  librg_event_type_get(librg_world *world, librg_event *event);
 LIBRG_API int64_t librg_event_owner_get(librg_world *world, librg_event *event);
@@ -6,6 +6,12 @@
 
 LIBRG_BEGIN_C_DECLS
 
+/* has the same layout as posix struct iovec */
+typedef struct librg_iovec {
+    char *base;
+    size_t len;
+} librg_iovec;
+
 // =======================================================================//
 // !
 // ! World data (de)packing methods
@@ -14,5 +20,12 @@ LIBRG_BEGIN_C_DECLS
 
 LIBRG_API int32_t librg_world_read(librg_world *world, int64_t owner_id, LIBRG_IN const char *buffer, size_t size, void *userdata);
 LIBRG_API int32_t librg_world_write(librg_world *world, int64_t owner_id, uint8_t chunk_radius, LIBRG_OUT char *buffer, LIBRG_INOUT size_t *size, void *userdata);
+LIBRG_API int32_t librg_world_write_split(librg_world *world, int64_t owner_id, uint8_t chunk_radius, LIBRG_OUT char *reliable, LIBRG_INOUT size_t *reliable_size, LIBRG_OUT char *unreliable, LIBRG_INOUT size_t *unreliable_size, void *userdata);
+LIBRG_API int64_t librg_world_write_sequence_get(librg_world *world, int64_t owner_id);
+LIBRG_API int8_t  librg_world_write_ack(librg_world *world, int64_t owner_id, int64_t sequence);
+LIBRG_API int32_t librg_world_write_begin(librg_world *world, int64_t owner_id, uint8_t chunk_radius, void *userdata);
+LIBRG_API int32_t librg_world_write_next(librg_world *world, int64_t owner_id, LIBRG_OUT char *buffer, LIBRG_INOUT size_t *size, LIBRG_OUT size_t *insufficient_size);
+LIBRG_API int32_t librg_world_write_iovec(librg_world *world, int64_t owner_id, uint8_t chunk_radius, LIBRG_INOUT librg_iovec *blocks, LIBRG_INOUT size_t *amount, LIBRG_OUT size_t *insufficient_size, void *userdata);
+LIBRG_API int32_t librg_world_write_all(librg_world *world, const int64_t *owner_ids, size_t owner_amount, uint8_t chunk_radius, LIBRG_OUT char **buffers, LIBRG_INOUT size_t *sizes, LIBRG_OUT int32_t *results, void *userdata);
 
 LIBRG_END_C_DECLS
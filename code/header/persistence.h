@@ -0,0 +1,18 @@
+// file: header/persistence.h
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! Persistence
+// !
+// =======================================================================//
+
+LIBRG_API int8_t librg_world_save(librg_world *world, LIBRG_OUT char *buffer, LIBRG_INOUT size_t *size);
+LIBRG_API int8_t librg_world_load(librg_world *world, LIBRG_IN const char *buffer, size_t size);
+
+LIBRG_END_C_DECLS
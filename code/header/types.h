@@ -15,6 +15,10 @@ LIBRG_BEGIN_C_DECLS
 typedef void librg_world;
 typedef void librg_event;
 typedef int64_t librg_chunk;
+typedef uint64_t librg_entity_handle;
+
+#define LIBRG_HANDLE_INVALID ((librg_entity_handle)0)
+#define LIBRG_LAYERS_ALL (~(uint64_t)0)
 
 #define LIBRG_OFFSET_BEG ((int16_t)0x8000)
 #define LIBRG_OFFSET_MID ((int16_t)0x0000)
@@ -38,7 +42,31 @@ typedef enum librg_event_type {
     LIBRG_ERROR_REMOVE,
 } librg_event_type;
 
+typedef struct librg_event_batch {
+    uint8_t type;               /* type of the event */
+    int64_t owner_id;           /* id of the owner who this batch is called for */
+    size_t amount;              /* amount of entities within the batch */
+    const int64_t *entity_ids;  /* ids of the entities */
+    char **buffers;             /* write: output slot of each entity, read: payload of each entity */
+    int32_t *sizes;             /* write: in - capacity of each slot, out - amount of written data, or LIBRG_WRITE_REJECT; read: payload sizes */
+    void *userdata;             /* userpointer that is passed from librg_world_write/librg_world_read fns */
+} librg_event_batch;
+
 typedef int32_t (*librg_event_fn)(librg_world *world, librg_event *event);
+typedef int32_t (*librg_event_batch_fn)(librg_world *world, librg_event_batch *batch);
+typedef int32_t (*librg_codec_fn)(const char *input, size_t input_size, char *output, size_t output_limit, const char *dictionary, size_t dictionary_size);
+
+typedef struct librg_allocator {
+    void *(*alloc)(void *userdata, size_t size);
+    void *(*realloc)(void *userdata, void *ptr, size_t old_size, size_t new_size); /* optional, alloc-copy-free is used if missing */
+    void  (*free)(void *userdata, void *ptr);
+    void *userdata;             /* passed to each of the callbacks, f.e. an arena of the world */
+} librg_allocator;
+
+typedef enum librg_wireformat {
+    LIBRG_WIREFORMAT_DEFAULT,
+    LIBRG_WIREFORMAT_COMPACT,
+} librg_wireformat;
 
 typedef enum librg_visibility {
     LIBRG_VISIBLITY_DEFAULT,
@@ -210,6 +210,9 @@
 #include "header/entity.h"
 #include "header/query.h"
 #include "header/packing.h"
+#include "header/bitstream.h"
+#include "header/compression.h"
+#include "header/persistence.h"
 
 /* Implementation part */
 #if defined(LIBRG_IMPLEMENTATION) && !defined(LIBRG_IMPLEMENTATION_DONE)
@@ -218,6 +221,7 @@
 #ifndef LIBRG_CUSTOM_ZPL
     #define ZPL_NANO
     #define ZPL_ENABLE_MATH
+    #define ZPL_ENABLE_TIMER
     #define ZPL_IMPL
 
     #include "vendor/zpl.h"
@@ -227,7 +231,10 @@
 #include "source/general.c"
 #include "source/entity.c"
 #include "source/query.c"
+#include "source/compression.c"
 #include "source/packing.c"
+#include "source/bitstream.c"
+#include "source/persistence.c"
 
 #endif // LIBRG_IMPLEMENTATION
 
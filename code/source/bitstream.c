@@ -0,0 +1,273 @@
+// file: source/bitstream.c
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#include <zpl.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! Bitstream primitives
+// !
+// =======================================================================//
+
+/* smallest three components of a normalized quaternion are within [-1/sqrt(2), 1/sqrt(2)] */
+#define LIBRG_BITSTREAM_QUAT_RANGE 0.707107f
+
+/* amount of bits required to store values within [0, range] */
+static LIBRG_ALWAYS_INLINE uint8_t librg_bitstream_bits(uint64_t range) {
+    uint8_t bits = 0;
+    while (range) { bits++; range >>= 1; }
+    return bits;
+}
+
+static LIBRG_ALWAYS_INLINE uint64_t librg_bitstream_zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static LIBRG_ALWAYS_INLINE int64_t librg_bitstream_unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+int8_t librg_bitstream_init(librg_bitstream *stream, char *buffer, size_t size) {
+    LIBRG_ASSERT(stream); if (!stream) return LIBRG_NULL_REFERENCE;
+
+    stream->buffer = buffer;
+    stream->size = buffer ? size : 0;
+    stream->position = 0;
+
+    return LIBRG_OK;
+}
+
+int8_t librg_bitstream_from_event(librg_world *world, librg_event *event, librg_bitstream *stream) {
+    LIBRG_ASSERT(event); if (!event) return LIBRG_EVENT_INVALID;
+    zpl_unused(world);
+    librg_event_t *e = (librg_event_t*)event;
+    return librg_bitstream_init(stream, e->buffer, e->size);
+}
+
+size_t librg_bitstream_size(librg_bitstream *stream) {
+    LIBRG_ASSERT(stream); if (!stream) return 0;
+    return (stream->position + 7) >> 3;
+}
+
+// =======================================================================//
+// !
+// ! Raw bits
+// !
+// =======================================================================//
+
+int8_t librg_bitstream_write_bits(librg_bitstream *stream, uint64_t value, uint8_t bits) {
+    LIBRG_ASSERT(stream); if (!stream) return LIBRG_NULL_REFERENCE;
+    if (bits > 64 || stream->position + bits > stream->size * 8) return LIBRG_WRITE_REJECT;
+    if (bits < 64) value &= ((uint64_t)1 << bits) - 1;
+
+    /* bits are stored starting from the least significant one */
+    while (bits > 0) {
+        size_t index = stream->position >> 3;
+        uint8_t offset = (uint8_t)(stream->position & 7);
+        uint8_t chunk = LIBRG_MIN((uint8_t)(8 - offset), bits);
+        uint8_t mask = (uint8_t)(((1u << chunk) - 1) << offset);
+
+        stream->buffer[index] = (char)(((uint8_t)stream->buffer[index] & ~mask) | ((uint8_t)(value << offset) & mask));
+
+        value >>= chunk;
+        bits -= chunk;
+        stream->position += chunk;
+    }
+
+    return LIBRG_OK;
+}
+
+int8_t librg_bitstream_read_bits(librg_bitstream *stream, uint64_t *value, uint8_t bits) {
+    LIBRG_ASSERT(stream && value); if (!stream || !value) return LIBRG_NULL_REFERENCE;
+    if (bits > 64 || stream->position + bits > stream->size * 8) return LIBRG_READ_INVALID;
+
+    uint64_t result = 0;
+    uint8_t shift = 0;
+
+    while (shift < bits) {
+        size_t index = stream->position >> 3;
+        uint8_t offset = (uint8_t)(stream->position & 7);
+        uint8_t chunk = LIBRG_MIN((uint8_t)(8 - offset), (uint8_t)(bits - shift));
+        uint8_t part = (uint8_t)(((uint8_t)stream->buffer[index] >> offset) & ((1u << chunk) - 1));
+
+        result |= (uint64_t)part << shift;
+
+        shift += chunk;
+        stream->position += chunk;
+    }
+
+    *value = result;
+    return LIBRG_OK;
+}
+
+// =======================================================================//
+// !
+// ! Quantization helpers
+// !
+// =======================================================================//
+
+int8_t librg_bitstream_write_int(librg_bitstream *stream, int64_t value, int64_t min, int64_t max) {
+    LIBRG_ASSERT(min <= max); if (min > max) return LIBRG_WRITE_REJECT;
+    value = LIBRG_MIN(LIBRG_MAX(value, min), max);
+
+    uint64_t range = (uint64_t)max - (uint64_t)min;
+    return librg_bitstream_write_bits(stream, (uint64_t)value - (uint64_t)min, librg_bitstream_bits(range));
+}
+
+int8_t librg_bitstream_read_int(librg_bitstream *stream, int64_t *value, int64_t min, int64_t max) {
+    LIBRG_ASSERT(min <= max); if (min > max) return LIBRG_READ_INVALID;
+    LIBRG_ASSERT(value); if (!value) return LIBRG_NULL_REFERENCE;
+
+    uint64_t range = (uint64_t)max - (uint64_t)min, raw = 0;
+    int8_t result = librg_bitstream_read_bits(stream, &raw, librg_bitstream_bits(range));
+    if (result != LIBRG_OK) return result;
+    if (raw > range) return LIBRG_READ_INVALID;
+
+    *value = (int64_t)((uint64_t)min + raw);
+    return LIBRG_OK;
+}
+
+int8_t librg_bitstream_write_float(librg_bitstream *stream, float value, float min, float max, float precision) {
+    LIBRG_ASSERT(min <= max && precision > 0); if (min > max || precision <= 0) return LIBRG_WRITE_REJECT;
+    value = LIBRG_MIN(LIBRG_MAX(value, min), max);
+
+    uint64_t steps = (uint64_t)((max - min) / precision + 0.5f);
+    uint64_t quantized = LIBRG_MIN((uint64_t)((value - min) / precision + 0.5f), steps);
+
+    return librg_bitstream_write_bits(stream, quantized, librg_bitstream_bits(steps));
+}
+
+int8_t librg_bitstream_read_float(librg_bitstream *stream, float *value, float min, float max, float precision) {
+    LIBRG_ASSERT(min <= max && precision > 0); if (min > max || precision <= 0) return LIBRG_READ_INVALID;
+    LIBRG_ASSERT(value); if (!value) return LIBRG_NULL_REFERENCE;
+
+    uint64_t steps = (uint64_t)((max - min) / precision + 0.5f), quantized = 0;
+    int8_t result = librg_bitstream_read_bits(stream, &quantized, librg_bitstream_bits(steps));
+    if (result != LIBRG_OK) return result;
+    if (quantized > steps) return LIBRG_READ_INVALID;
+
+    *value = LIBRG_MIN(min + (float)quantized * precision, max);
+    return LIBRG_OK;
+}
+
+/**
+ * Smallest three: index of the largest component is stored in 2 bits,
+ * the other three components are stored using the specified amount of bits each.
+ * Largest component is restored from the unit length, its sign is dropped, since q and -q represent same rotation.
+ */
+int8_t librg_bitstream_write_quat(librg_bitstream *stream, const float *quat, uint8_t bits) {
+    LIBRG_ASSERT(quat); if (!quat) return LIBRG_NULL_REFERENCE;
+    LIBRG_ASSERT(bits > 0 && bits <= 32); if (bits == 0 || bits > 32) return LIBRG_WRITE_REJECT;
+    if (!stream || stream->position + 2 + bits * 3 > stream->size * 8) return LIBRG_WRITE_REJECT;
+
+    uint8_t largest = 0;
+    for (uint8_t i = 1; i < 4; ++i) {
+        if (zpl_abs(quat[i]) > zpl_abs(quat[largest])) largest = i;
+    }
+
+    float sign = quat[largest] < 0 ? -1.0f : 1.0f;
+    uint64_t steps = ((uint64_t)1 << bits) - 1;
+
+    librg_bitstream_write_bits(stream, largest, 2);
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+
+        float value = zpl_clamp(quat[i] * sign, -LIBRG_BITSTREAM_QUAT_RANGE, LIBRG_BITSTREAM_QUAT_RANGE);
+        float normalized = (value + LIBRG_BITSTREAM_QUAT_RANGE) / (2 * LIBRG_BITSTREAM_QUAT_RANGE);
+        librg_bitstream_write_bits(stream, (uint64_t)(normalized * steps + 0.5f), bits);
+    }
+
+    return LIBRG_OK;
+}
+
+int8_t librg_bitstream_read_quat(librg_bitstream *stream, float *quat, uint8_t bits) {
+    LIBRG_ASSERT(quat); if (!quat) return LIBRG_NULL_REFERENCE;
+    LIBRG_ASSERT(bits > 0 && bits <= 32); if (bits == 0 || bits > 32) return LIBRG_READ_INVALID;
+    if (!stream || stream->position + 2 + bits * 3 > stream->size * 8) return LIBRG_READ_INVALID;
+
+    uint64_t largest = 0, raw = 0;
+    uint64_t steps = ((uint64_t)1 << bits) - 1;
+    float sum = 0;
+
+    librg_bitstream_read_bits(stream, &largest, 2);
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+
+        librg_bitstream_read_bits(stream, &raw, bits);
+        quat[i] = ((float)raw / steps) * (2 * LIBRG_BITSTREAM_QUAT_RANGE) - LIBRG_BITSTREAM_QUAT_RANGE;
+        sum += quat[i] * quat[i];
+    }
+
+    quat[largest] = zpl_sqrt(LIBRG_MAX(0.0f, 1.0f - sum));
+    return LIBRG_OK;
+}
+
+/**
+ * Delta against the previous value: a single bit when the value did not change,
+ * small zigzag-encoded difference when it fits into small_bits, or a full zigzag-encoded value otherwise.
+ */
+int8_t librg_bitstream_write_delta(librg_bitstream *stream, int64_t value, int64_t previous, uint8_t small_bits, uint8_t bits) {
+    LIBRG_ASSERT(small_bits < 64 && bits <= 64); if (small_bits >= 64 || bits > 64) return LIBRG_WRITE_REJECT;
+    if (!stream) return LIBRG_NULL_REFERENCE;
+
+    size_t position = stream->position;
+    uint64_t difference = librg_bitstream_zigzag((int64_t)((uint64_t)value - (uint64_t)previous));
+    int8_t result = LIBRG_OK;
+
+    if (value == previous) {
+        return librg_bitstream_write_bits(stream, 0, 1);
+    }
+
+    if (small_bits > 0 && difference < ((uint64_t)1 << small_bits)) {
+        result = librg_bitstream_write_bits(stream, 3, 2);
+        if (result == LIBRG_OK) result = librg_bitstream_write_bits(stream, difference, small_bits);
+    } else {
+        uint64_t encoded = librg_bitstream_zigzag(value);
+
+        /* value does not fit into the specified amount of bits */
+        if (bits < 64 && encoded >= ((uint64_t)1 << bits)) return LIBRG_WRITE_REJECT;
+
+        result = librg_bitstream_write_bits(stream, 1, 2);
+        if (result == LIBRG_OK) result = librg_bitstream_write_bits(stream, encoded, bits);
+    }
+
+    /* do not leave partially written values */
+    if (result != LIBRG_OK) stream->position = position;
+    return result;
+}
+
+int8_t librg_bitstream_read_delta(librg_bitstream *stream, int64_t *value, int64_t previous, uint8_t small_bits, uint8_t bits) {
+    LIBRG_ASSERT(small_bits < 64 && bits <= 64); if (small_bits >= 64 || bits > 64) return LIBRG_READ_INVALID;
+    LIBRG_ASSERT(value); if (!value || !stream) return LIBRG_NULL_REFERENCE;
+
+    uint64_t flag = 0, raw = 0;
+    int8_t result = librg_bitstream_read_bits(stream, &flag, 1);
+    if (result != LIBRG_OK) return result;
+
+    if (!flag) {
+        *value = previous;
+        return LIBRG_OK;
+    }
+
+    if ((result = librg_bitstream_read_bits(stream, &flag, 1)) != LIBRG_OK) return result;
+
+    if (flag) {
+        if ((result = librg_bitstream_read_bits(stream, &raw, small_bits)) != LIBRG_OK) return result;
+        *value = (int64_t)((uint64_t)previous + (uint64_t)librg_bitstream_unzigzag(raw));
+    } else {
+        if ((result = librg_bitstream_read_bits(stream, &raw, bits)) != LIBRG_OK) return result;
+        *value = librg_bitstream_unzigzag(raw);
+    }
+
+    return LIBRG_OK;
+}
+
+#undef LIBRG_BITSTREAM_QUAT_RANGE
+
+LIBRG_END_C_DECLS
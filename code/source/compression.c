@@ -0,0 +1,339 @@
+// file: source/compression.c
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#include <zpl.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! Varints
+// !
+// =======================================================================//
+
+static LIBRG_ALWAYS_INLINE size_t librg_varint_write(char *out, uint64_t value) {
+    size_t written = 0;
+
+    while (value >= 0x80) {
+        out[written++] = (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    out[written++] = (char)value;
+    return written;
+}
+
+static LIBRG_ALWAYS_INLINE size_t librg_varint_read(const char *in, size_t size, uint64_t *value) {
+    uint64_t result = 0;
+
+    for (size_t i = 0; i < size && i < 10; ++i) {
+        result |= (uint64_t)((uint8_t)in[i] & 0x7f) << (7 * i);
+
+        if (((uint8_t)in[i] & 0x80) == 0) {
+            *value = result;
+            return i + 1;
+        }
+    }
+
+    /* truncated or malformed value */
+    return 0;
+}
+
+// =======================================================================//
+// !
+// ! Built-in LZ codec
+// !
+// =======================================================================//
+
+/* marks a compressed buffer, never used as a segment type */
+#define LIBRG_COMPRESSION_FRAME 0xFE
+
+#define LIBRG_LZ_MINMATCH 4
+#define LIBRG_LZ_HASHBITS 12
+#define LIBRG_LZ_TRAIN_GRAM 8
+
+/* dictionary and input are treated as a single continuous window */
+#define librg_lz_at(pos) ((pos) < dictionary_size ? dictionary[(pos)] : input[(pos) - dictionary_size])
+
+static LIBRG_ALWAYS_INLINE uint32_t librg_lz_hash(uint32_t value) {
+    return (value * 2654435761u) >> (32 - LIBRG_LZ_HASHBITS);
+}
+
+static LIBRG_ALWAYS_INLINE uint32_t librg_lz_read32(const char *input, const char *dictionary, size_t dictionary_size, size_t pos) {
+    return (uint32_t)(uint8_t)librg_lz_at(pos)
+        | (uint32_t)(uint8_t)librg_lz_at(pos + 1) << 8
+        | (uint32_t)(uint8_t)librg_lz_at(pos + 2) << 16
+        | (uint32_t)(uint8_t)librg_lz_at(pos + 3) << 24;
+}
+
+/**
+ * Stream is a list of sequences: varint literal length, literals, varint match length (biased, 0 marks the end),
+ * and varint match offset back from the current position, that can reach into the dictionary.
+ */
+int32_t librg_compression_lz_encode(const char *input, size_t input_size, char *output, size_t output_limit, const char *dictionary, size_t dictionary_size) {
+    LIBRG_ASSERT(input && output); if (!input || !output) return LIBRG_NULL_REFERENCE;
+    if (!dictionary) dictionary_size = 0;
+
+    int32_t table[1 << LIBRG_LZ_HASHBITS];
+    for (size_t i = 0; i < (1 << LIBRG_LZ_HASHBITS); ++i) table[i] = -1;
+
+    size_t total = dictionary_size + input_size;
+    size_t pos = dictionary_size, anchor = dictionary_size;
+    size_t written = 0, last_offset = 0;
+    char header[30];
+
+    if (total > ZPL_I32_MAX) return LIBRG_WRITE_REJECT;
+
+    /* prime matcher with the dictionary */
+    for (size_t i = 0; i + LIBRG_LZ_MINMATCH <= dictionary_size; ++i)
+        table[librg_lz_hash(librg_lz_read32(input, dictionary, dictionary_size, i))] = (int32_t)i;
+
+    #define librg_lz_emit(literal_end, match_length, match_offset) do { \
+        size_t hsize = librg_varint_write(header, (literal_end) - anchor); \
+        if (written + hsize + ((literal_end) - anchor) + 20 > output_limit) return LIBRG_WRITE_REJECT; \
+        zpl_memcopy(output + written, header, hsize); written += hsize; \
+        zpl_memcopy(output + written, input + (anchor - dictionary_size), (literal_end) - anchor); \
+        written += (literal_end) - anchor; \
+        written += librg_varint_write(output + written, (match_length) ? (match_length) - LIBRG_LZ_MINMATCH + 1 : 0); \
+        if (match_length) written += librg_varint_write(output + written, (match_offset)); \
+    } while (0)
+
+    while (pos + LIBRG_LZ_MINMATCH <= total) {
+        uint32_t hash = librg_lz_hash(librg_lz_read32(input, dictionary, dictionary_size, pos));
+        int32_t candidate = table[hash];
+        size_t length = 0;
+
+        table[hash] = (int32_t)pos;
+
+        if (candidate >= 0) {
+            while (pos + length < total && librg_lz_at((size_t)candidate + length) == librg_lz_at(pos + length)) length++;
+        }
+
+        /* packed entities usually repeat with the same stride, so try the last offset as well */
+        if (last_offset > 0 && last_offset <= pos) {
+            size_t repeated = 0;
+            while (pos + repeated < total && librg_lz_at(pos - last_offset + repeated) == librg_lz_at(pos + repeated)) repeated++;
+
+            if (repeated >= length) {
+                length = repeated;
+                candidate = (int32_t)(pos - last_offset);
+            }
+        }
+
+        if (length < LIBRG_LZ_MINMATCH) {
+            pos++;
+            continue;
+        }
+
+        last_offset = pos - (size_t)candidate;
+        librg_lz_emit(pos, length, last_offset);
+
+        /* keep matcher aware of the positions within the match */
+        for (size_t i = pos + 1; i < pos + length && i + LIBRG_LZ_MINMATCH <= total; i += 2)
+            table[librg_lz_hash(librg_lz_read32(input, dictionary, dictionary_size, i))] = (int32_t)i;
+
+        pos += length;
+        anchor = pos;
+    }
+
+    /* last literals, followed by an empty match */
+    librg_lz_emit(total, 0, 0);
+
+    #undef librg_lz_emit
+    return (int32_t)written;
+}
+
+int32_t librg_compression_lz_decode(const char *input, size_t input_size, char *output, size_t output_limit, const char *dictionary, size_t dictionary_size) {
+    LIBRG_ASSERT(input && output); if (!input || !output) return LIBRG_NULL_REFERENCE;
+    if (!dictionary) dictionary_size = 0;
+
+    size_t read = 0, written = 0;
+
+    while (read < input_size) {
+        uint64_t literal = 0, match = 0, offset = 0;
+        size_t r = librg_varint_read(input + read, input_size - read, &literal); read += r;
+        if (!r || literal > input_size - read || literal > output_limit - written) return LIBRG_READ_INVALID;
+
+        zpl_memcopy(output + written, input + read, literal);
+        written += literal;
+        read += literal;
+
+        r = librg_varint_read(input + read, input_size - read, &match); read += r;
+        if (!r) return LIBRG_READ_INVALID;
+
+        /* end of the stream */
+        if (match == 0) break;
+
+        r = librg_varint_read(input + read, input_size - read, &offset); read += r;
+        size_t length = match + LIBRG_LZ_MINMATCH - 1;
+
+        if (!r || offset == 0 || offset > dictionary_size + written || length > output_limit - written) {
+            return LIBRG_READ_INVALID;
+        }
+
+        /* copy byte by byte, since source and target might overlap */
+        size_t source = dictionary_size + written - offset;
+        for (size_t i = 0; i < length; ++i, ++source) {
+            output[written++] = source < dictionary_size ? dictionary[source] : output[source - dictionary_size];
+        }
+    }
+
+    if (read != input_size) return LIBRG_READ_INVALID;
+    return (int32_t)written;
+}
+
+#undef librg_lz_at
+
+// =======================================================================//
+// !
+// ! Dictionary training
+// !
+// =======================================================================//
+
+typedef struct {
+    uint64_t gram;
+    int64_t count;
+} librg_lz_gram_t;
+
+static ZPL_COMPARE_PROC(librg_util_gramcmp) {
+    const librg_lz_gram_t *ga = (const librg_lz_gram_t *)a;
+    const librg_lz_gram_t *gb = (const librg_lz_gram_t *)b;
+    return (ga->count < gb->count) ? 1 : (ga->count > gb->count) ? -1 : 0;
+}
+
+/**
+ * Counts all short byte sequences within the samples, and fills the dictionary with the most repeated ones.
+ * Most frequent sequences are placed at the end of dictionary, closer to the data, to get shorter offsets.
+ */
+int32_t librg_compression_dictionary_train(const char **samples, const size_t *sample_sizes, size_t sample_amount, char *dictionary, size_t dictionary_size) {
+    LIBRG_ASSERT(samples && sample_sizes && dictionary); if (!samples || !sample_sizes || !dictionary) return LIBRG_NULL_REFERENCE;
+
+    zpl_allocator allocator = librg_alloc_wrap();
+    librg_table_i64 counts = {0};
+    librg_table_i64_init(&counts, allocator);
+
+    for (size_t i = 0; i < sample_amount; ++i) {
+        for (size_t j = 0; samples[i] && j + LIBRG_LZ_TRAIN_GRAM <= sample_sizes[i]; ++j) {
+            uint64_t gram = 0;
+            zpl_memcopy(&gram, samples[i] + j, LIBRG_LZ_TRAIN_GRAM);
+
+            int64_t *count = librg_table_i64_get(&counts, (int64_t)gram);
+            librg_table_i64_set(&counts, (int64_t)gram, count ? *count + 1 : 1);
+        }
+    }
+
+    zpl_array(librg_lz_gram_t) grams = NULL;
+    zpl_array_init_reserve(grams, allocator, (zpl_isize)zpl_array_count(counts.entries));
+
+    for (int i = 0; i < zpl_array_count(counts.entries); ++i) {
+        if (counts.entries[i].value < 2) continue;
+        librg_lz_gram_t gram = { (uint64_t)counts.entries[i].key, counts.entries[i].value };
+        zpl_array_append(grams, gram);
+    }
+
+    zpl_sort_array(grams, zpl_array_count(grams), librg_util_gramcmp);
+
+    /* fill from the end, skipping sequences that are already present */
+    size_t position = dictionary_size;
+
+    for (int i = 0; i < zpl_array_count(grams) && position >= LIBRG_LZ_TRAIN_GRAM; ++i) {
+        const char *gram = (const char *)&grams[i].gram;
+        int8_t found = LIBRG_FALSE;
+
+        for (size_t j = position; j + LIBRG_LZ_TRAIN_GRAM <= dictionary_size && !found; ++j)
+            found = zpl_memcompare(dictionary + j, gram, LIBRG_LZ_TRAIN_GRAM) == 0;
+
+        if (found) continue;
+
+        position -= LIBRG_LZ_TRAIN_GRAM;
+        zpl_memcopy(dictionary + position, gram, LIBRG_LZ_TRAIN_GRAM);
+    }
+
+    size_t size = dictionary_size - position;
+    zpl_memmove(dictionary, dictionary + position, size);
+
+    zpl_array_free(grams);
+    librg_table_i64_destroy(&counts);
+
+    return (int32_t)size;
+}
+
+// =======================================================================//
+// !
+// ! World compression stage
+// !
+// =======================================================================//
+
+/* compresses the buffer in-place, keeps it raw if compression did not help */
+static size_t librg_world_compress(librg_world_t *wld, char *buffer, size_t size) {
+    librg_codec_fn encode = wld->compression_encode ? wld->compression_encode : librg_compression_lz_encode;
+    zpl_f64 started = zpl_time_rel();
+
+    char header[11];
+    size_t hsize = 0;
+    header[hsize++] = (char)LIBRG_COMPRESSION_FRAME;
+    hsize += librg_varint_write(header + hsize, size);
+
+    size_t result = size;
+
+    /* buffer is left uncompressed, if there is no memory for the scratch */
+    if (size > hsize && size <= LIBRG_COMPRESSION_MAXSIZE && LIBRG_ARRAY_RESERVE(wld->compression_scratch, (zpl_isize)size)) {
+        zpl_array_resize(wld->compression_scratch, (zpl_isize)size);
+
+        int32_t encoded = encode(
+            buffer, size, wld->compression_scratch, size - hsize,
+            wld->compression_dictionary, zpl_array_count(wld->compression_dictionary)
+        );
+
+        if (encoded >= 0 && hsize + (size_t)encoded < size) {
+            zpl_memcopy(buffer, header, hsize);
+            zpl_memcopy(buffer + hsize, wld->compression_scratch, encoded);
+            result = hsize + encoded;
+        }
+    }
+
+    wld->compression_stats.frames++;
+    wld->compression_stats.raw_bytes += size;
+    wld->compression_stats.compressed_bytes += result;
+    wld->compression_stats.compress_time += zpl_time_rel() - started;
+
+    return result;
+}
+
+/* returns size of the decompressed data, stored within the compression scratch */
+static int32_t librg_world_decompress(librg_world_t *wld, const char *buffer, size_t size) {
+    librg_codec_fn decode = wld->compression_decode ? wld->compression_decode : librg_compression_lz_decode;
+    zpl_f64 started = zpl_time_rel();
+
+    uint64_t raw_size = 0;
+    size_t hsize = librg_varint_read(buffer + 1, size - 1, &raw_size);
+    if (!hsize || raw_size > LIBRG_COMPRESSION_MAXSIZE) return LIBRG_READ_INVALID;
+    if (!LIBRG_ARRAY_RESERVE(wld->compression_scratch, (zpl_isize)raw_size)) return LIBRG_READ_INVALID;
+
+    zpl_array_resize(wld->compression_scratch, (zpl_isize)raw_size);
+
+    int32_t decoded = decode(
+        buffer + 1 + hsize, size - 1 - hsize, wld->compression_scratch, raw_size,
+        wld->compression_dictionary, zpl_array_count(wld->compression_dictionary)
+    );
+
+    wld->compression_stats.decompress_time += zpl_time_rel() - started;
+
+    if (decoded < 0 || (uint64_t)decoded != raw_size) return LIBRG_READ_INVALID;
+    return decoded;
+}
+
+int8_t librg_world_compression_stats(librg_world *world, librg_compression_stats *stats) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(stats); if (!stats) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    *stats = wld->compression_stats;
+    stats->ratio = stats->raw_bytes ? (float)((double)stats->compressed_bytes / (double)stats->raw_bytes) : 1.0f;
+
+    return LIBRG_OK;
+}
+
+LIBRG_END_C_DECLS
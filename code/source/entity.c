@@ -13,6 +13,67 @@ LIBRG_BEGIN_C_DECLS
 // !
 // =======================================================================//
 
+/* fills in default values of a newly tracked entity */
+static void librg_entity_defaults(librg_world_t *wld, librg_entity_t *entity) {
+    for (int i = 0; i < LIBRG_ENTITY_MAXCHUNKS; ++i) entity->chunks[i] = LIBRG_CHUNK_INVALID;
+
+    entity->owner_id = LIBRG_OWNER_INVALID;
+    entity->parent_id = LIBRG_ENTITY_INVALID;
+    entity->flag_owner_updated = LIBRG_TRUE;
+    entity->priority_weight = 1.0f;
+    entity->layers = LIBRG_LAYERS_ALL;
+    entity->dirty_epoch = ++wld->dirty_epoch;
+}
+
+/* removes the entity from the children of its parent */
+static void librg_entity_unlink(librg_world_t *wld, int64_t entity_id, librg_entity_t *entity) {
+    librg_entity_t *parent = librg_table_ent_get(&wld->entity_map, entity->parent_id);
+
+    for (zpl_isize i = 0; parent && i < zpl_array_count(parent->children); ++i) {
+        if (parent->children[i] != entity_id) continue;
+        zpl_array_remove_at(parent->children, i);
+        break;
+    }
+
+    entity->parent_id = LIBRG_ENTITY_INVALID;
+}
+
+/* removes the entity from its parent, and detaches all of its children */
+static void librg_entity_attachments_clear(librg_world_t *wld, int64_t entity_id, librg_entity_t *entity) {
+    librg_entity_unlink(wld, entity_id, entity);
+    if (!entity->children) return;
+
+    for (zpl_isize i = 0; i < zpl_array_count(entity->children); ++i) {
+        librg_entity_t *child = librg_table_ent_get(&wld->entity_map, entity->children[i]);
+        if (child) child->parent_id = LIBRG_ENTITY_INVALID;
+    }
+
+    zpl_array_free(entity->children);
+    entity->children = NULL;
+}
+
+/* releases the handle slot of an entity that is about to be removed, invalidating existing handles */
+static void librg_entity_slot_release(librg_world_t *wld, librg_entity_t *entity) {
+    if (!entity->slot) return;
+
+    librg_entity_slot_t *slot = &wld->entity_slots[entity->slot - 1];
+    slot->generation++;
+    slot->index = -1;
+
+    zpl_array_append(wld->entity_slots_free, entity->slot - 1);
+    entity->slot = 0;
+}
+
+/* points handle slots to the new locations of entities, after the storage was shifted */
+static void librg_entity_slot_refresh(librg_world_t *wld, zpl_isize from) {
+    if (zpl_array_count(wld->entity_slots) == zpl_array_count(wld->entity_slots_free)) return;
+
+    for (zpl_isize i = from; i < zpl_array_count(wld->entity_map.entries); ++i) {
+        uint32_t slot = wld->entity_map.entries[i].value.slot;
+        if (slot) wld->entity_slots[slot - 1].index = (int32_t)i;
+    }
+}
+
 int8_t librg_entity_track(librg_world *world, int64_t entity_id) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -26,15 +87,35 @@ int8_t librg_entity_track(librg_world *world, int64_t entity_id) {
     }
 
     librg_entity_t _entity = {0};
+    librg_entity_defaults(wld, &_entity);
     librg_table_ent_set(&wld->entity_map, entity_id, _entity);
 
-    /* set defaults */
-    librg_entity_chunk_set(world, entity_id, LIBRG_CHUNK_INVALID);
-    librg_entity_owner_set(world, entity_id, LIBRG_OWNER_INVALID);
-
     return LIBRG_OK;
 }
 
+int32_t librg_entity_track_many(librg_world *world, const int64_t *entity_ids, size_t amount) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(entity_ids || !amount); if (!entity_ids && amount) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    int32_t tracked = 0;
+
+    /* make room for all of the entities at once, instead of growing the table multiple times */
+    LIBRG_TABLE_RESERVE(librg_table_ent_, &wld->entity_map, zpl_array_count(wld->entity_map.entries) + (zpl_isize)amount);
+
+    for (size_t i = 0; i < amount; ++i) {
+        if (entity_ids[i] < 0 || librg_table_ent_get(&wld->entity_map, entity_ids[i]) != NULL) {
+            continue;
+        }
+
+        librg_entity_t _entity = {0};
+        librg_entity_defaults(wld, &_entity);
+        librg_table_ent_set(&wld->entity_map, entity_ids[i], _entity);
+        tracked++;
+    }
+
+    return tracked;
+}
+
 int8_t librg_entity_untrack(librg_world *world, int64_t entity_id) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -59,12 +140,12 @@ int8_t librg_entity_untrack(librg_world *world, int64_t entity_id) {
                 owned++;
         }
 
-        librg_table_i64 *snapshot = librg_table_tbl_get(&wld->owner_map, entity->owner_id);
+        librg_owner_t *owner = librg_table_own_get(&wld->owner_map, entity->owner_id);
 
         /* free up our snapshot storage, if owner does not own other entities (except current one) */
-        if (snapshot && owned <= 1) {
-            librg_table_i64_destroy(snapshot);
-            librg_table_tbl_remove(&wld->owner_map, entity->owner_id);
+        if (owner && owned <= 1) {
+            librg_owner_destroy(wld, owner);
+            librg_table_own_remove(&wld->owner_map, entity->owner_id);
         }
 
         /* cleanup owner-entity pair */
@@ -77,15 +158,90 @@ int8_t librg_entity_untrack(librg_world *world, int64_t entity_id) {
     }
 
     /* cleanup owner visibility */
-    if (entity->flag_visbility_owner_enabled) {
-        entity->flag_visbility_owner_enabled = LIBRG_FALSE;
-        librg_table_i8_destroy(&entity->owner_visibility_map);
-    }
+    librg_visibility_owner_destroy(entity);
+
+    librg_entity_attachments_clear(wld, entity_id, entity);
+    librg_entity_slot_release(wld, entity);
 
+    zpl_isize index = librg_table_ent__find(&wld->entity_map, entity_id).entry_index;
     librg_table_ent_remove(&wld->entity_map, entity_id);
+    librg_entity_slot_refresh(wld, index);
+
     return LIBRG_OK;
 }
 
+int32_t librg_entity_untrack_many(librg_world *world, const int64_t *entity_ids, size_t amount) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(entity_ids || !amount); if (!entity_ids && amount) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_table_i8 removed = {0};
+    librg_table_i8 owners = {0};
+    librg_table_i8_init(&removed, wld->allocator);
+    librg_table_i8_init(&owners, wld->allocator);
+
+    /* same rules as for the single entity */
+    for (size_t i = 0; i < amount; ++i) {
+        librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_ids[i]);
+        if (!entity || entity->flag_foreign == LIBRG_TRUE) continue;
+        if (librg_table_i8_get(&removed, entity_ids[i])) continue;
+
+        if (entity->owner_id != LIBRG_OWNER_INVALID) {
+            librg_table_i8_set(&owners, entity->owner_id, 1);
+        }
+
+        librg_visibility_owner_destroy(entity);
+
+        librg_entity_attachments_clear(wld, entity_ids[i], entity);
+        librg_entity_slot_release(wld, entity);
+        librg_table_i8_set(&removed, entity_ids[i], 1);
+    }
+
+    int32_t untracked = (int32_t)zpl_array_count(removed.entries);
+
+    if (untracked > 0) {
+        /* cleanup owner-entity pairs in a single pass */
+        zpl_isize count = 0;
+        for (zpl_isize i = 0; i < zpl_array_count(wld->owner_entity_pairs); ++i) {
+            if (librg_table_i8_get(&removed, wld->owner_entity_pairs[i].entity_id)) continue;
+            wld->owner_entity_pairs[count++] = wld->owner_entity_pairs[i];
+        }
+        zpl_array_resize(wld->owner_entity_pairs, count);
+
+        /* compact entity storage, and rebuild its hashes only once */
+        count = 0;
+        for (zpl_isize i = 0; i < zpl_array_count(wld->entity_map.entries); ++i) {
+            if (librg_table_i8_get(&removed, wld->entity_map.entries[i].key)) continue;
+            wld->entity_map.entries[count++] = wld->entity_map.entries[i];
+        }
+        zpl_array_resize(wld->entity_map.entries, count);
+        librg_table_ent_rehash_fast(&wld->entity_map);
+        librg_entity_slot_refresh(wld, 0);
+
+        /* free up snapshot storage of owners, that do not own any entities anymore */
+        for (zpl_isize i = 0; i < zpl_array_count(wld->entity_map.entries); ++i) {
+            int64_t owner_id = wld->entity_map.entries[i].value.owner_id;
+            int8_t *owner_state = librg_table_i8_get(&owners, owner_id);
+            if (owner_state) *owner_state = 0;
+        }
+
+        for (zpl_isize i = 0; i < zpl_array_count(owners.entries); ++i) {
+            if (!owners.entries[i].value) continue;
+
+            librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owners.entries[i].key);
+            if (!owner) continue;
+
+            librg_owner_destroy(wld, owner);
+            librg_table_own_remove(&wld->owner_map, owners.entries[i].key);
+        }
+    }
+
+    librg_table_i8_destroy(&removed);
+    librg_table_i8_destroy(&owners);
+
+    return untracked;
+}
+
 int8_t librg_entity_tracked(librg_world *world, int64_t entity_id) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_FALSE;
     librg_world_t *wld = (librg_world_t *)world;
@@ -136,10 +292,43 @@ int8_t librg_entity_chunk_set(librg_world *world, int64_t entity_id, librg_chunk
 
     for (int i = 0; i < LIBRG_ENTITY_MAXCHUNKS; ++i) entity->chunks[i] = LIBRG_CHUNK_INVALID;
     entity->chunks[0] = chunk;
+    entity->flag_coverage_cached = LIBRG_FALSE;
 
     return LIBRG_OK;
 }
 
+int32_t librg_entity_chunk_set_many(librg_world *world, const int64_t *entity_ids, const librg_chunk *chunks, size_t amount) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT((entity_ids && chunks) || !amount); if ((!entity_ids || !chunks) && amount) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    zpl_isize total = zpl_array_count(wld->entity_map.entries);
+    zpl_isize next = 0;
+    int32_t updated = 0;
+
+    /* ids that follow the order of the entity storage (e.g. the order they were tracked in) are matched in a single pass, */
+    /* the rest are looked up in the hash table, and the pass continues from where they are stored */
+    for (size_t i = 0; i < amount; ++i) {
+        librg_entity_t *entity = NULL;
+
+        if (next < total && wld->entity_map.entries[next].key == (zpl_u64)entity_ids[i]) {
+            entity = &wld->entity_map.entries[next++].value;
+        } else {
+            zpl_isize index = librg_table_ent__find(&wld->entity_map, (zpl_u64)entity_ids[i]).entry_index;
+            if (index < 0) continue;
+
+            entity = &wld->entity_map.entries[index].value;
+            next = index + 1;
+        }
+
+        for (int j = 0; j < LIBRG_ENTITY_MAXCHUNKS; ++j) entity->chunks[j] = LIBRG_CHUNK_INVALID;
+        entity->chunks[0] = chunks[i];
+        entity->flag_coverage_cached = LIBRG_FALSE;
+        updated++;
+    }
+
+    return updated;
+}
+
 librg_chunk librg_entity_chunk_get(librg_world *world, int64_t entity_id) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -200,14 +389,9 @@ int8_t librg_entity_owner_set(librg_world *world, int64_t entity_id, int64_t own
         while (newtoken == 0 || newtoken == entity->ownership_token);
         entity->ownership_token = newtoken;
 
-        /* fetch or create a new subtable */
-        librg_table_i64 *snapshot = librg_table_tbl_get(&wld->owner_map, owner_id);
-
-        if (!snapshot) {
-            librg_table_i64 _i64 = {0};
-            librg_table_tbl_set(&wld->owner_map, owner_id, _i64);
-            snapshot = librg_table_tbl_get(&wld->owner_map, owner_id);
-            librg_table_i64_init(snapshot, wld->allocator);
+        /* fetch or create a new owner storage */
+        if (!librg_table_own_get(&wld->owner_map, owner_id)) {
+            librg_owner_create(wld, owner_id);
         }
     } else {
         entity->ownership_token = 0;
@@ -239,6 +423,50 @@ LIBRG_DEPRECATED(7.0) int8_t librg_entity_radius_get(librg_world *world, int64_t
     return -1;
 }
 
+int8_t librg_entity_layers_set(librg_world *world, int64_t entity_id, uint64_t layers) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->layers = layers;
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_layers_get(librg_world *world, int64_t entity_id, uint64_t *layers) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(layers); if (!layers) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    *layers = entity->layers;
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_visibility_range_set(librg_world *world, int64_t entity_id, uint8_t chunk_range) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->visibility_range = chunk_range;
+    return LIBRG_OK;
+}
+
+int32_t librg_entity_visibility_range_get(librg_world *world, int64_t entity_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    return entity->visibility_range;
+}
+
 int8_t librg_entity_dimension_set(librg_world *world, int64_t entity_id, int32_t dimension) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -260,6 +488,54 @@ int32_t librg_entity_dimension_get(librg_world *world, int64_t entity_id) {
     return entity->dimension;
 }
 
+int8_t librg_entity_priority_set(librg_world *world, int64_t entity_id, float weight) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->priority_weight = weight < 0 ? 0 : weight;
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_priority_get(librg_world *world, int64_t entity_id, float *weight) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(weight); if (!weight) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    *weight = entity->priority_weight;
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_dirty_set(librg_world *world, int64_t entity_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->dirty_epoch = ++wld->dirty_epoch;
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_dirty_get(librg_world *world, int64_t entity_id, int64_t owner_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+    if (owner == NULL) return LIBRG_OWNER_INVALID;
+
+    int64_t *sent_epoch = librg_table_i64_get(&owner->sent_epochs, entity_id);
+    return !sent_epoch || (uint64_t)*sent_epoch < entity->dirty_epoch;
+}
+
 int8_t librg_entity_userdata_set(librg_world *world, int64_t entity_id, void *data) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -292,6 +568,7 @@ int8_t librg_entity_chunkarray_set(librg_world *world, int64_t entity_id, const
 
     for (int i = 0; i < LIBRG_ENTITY_MAXCHUNKS; ++i) entity->chunks[i] = LIBRG_CHUNK_INVALID;
     zpl_memcopy(entity->chunks, values, sizeof(librg_chunk) * LIBRG_MIN(chunk_amount, LIBRG_ENTITY_MAXCHUNKS));
+    entity->flag_coverage_cached = LIBRG_FALSE;
 
     return LIBRG_OK;
 
@@ -318,6 +595,71 @@ int8_t librg_entity_chunkarray_get(librg_world *world, int64_t entity_id, librg_
     return (int8_t)(LIBRG_ENTITY_MAXCHUNKS - buffer_limit);
 }
 
+/* converts a real position range on a single axis into a range of chunk grid cells, clamped to the world size */
+static int8_t librg_entity_aabb_axis(double min, double max, uint16_t chunksize, int16_t offset, uint16_t worldsize, int32_t *from, int32_t *to) {
+    double lo = LIBRG_MIN(min, max) / chunksize, hi = LIBRG_MAX(min, max) / chunksize;
+    int32_t a = librg_util_chunkoffset_line((int16_t)LIBRG_MAX(lo, INT16_MIN), offset, worldsize);
+    int32_t b = librg_util_chunkoffset_line((int16_t)LIBRG_MIN(hi, INT16_MAX), offset, worldsize);
+
+    if (b < 0 || a >= worldsize) return LIBRG_FALSE;
+
+    *from = LIBRG_MAX(a, 0);
+    *to = LIBRG_MIN(b, worldsize - 1);
+    return LIBRG_TRUE;
+}
+
+int8_t librg_entity_aabb_set(librg_world *world, int64_t entity_id, const double *min, const double *max) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(min && max); if (!min || !max) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    /* empty box is used for entities located outside of the world */
+    int32_t coverage[6] = {0, -1, 0, -1, 0, -1};
+
+    if (!librg_entity_aabb_axis(min[0], max[0], wld->chunksize.x, wld->chunkoffset.x, wld->worldsize.x, &coverage[0], &coverage[1])
+     || !librg_entity_aabb_axis(min[1], max[1], wld->chunksize.y, wld->chunkoffset.y, wld->worldsize.y, &coverage[2], &coverage[3])
+     || !librg_entity_aabb_axis(min[2], max[2], wld->chunksize.z, wld->chunkoffset.z, wld->worldsize.z, &coverage[4], &coverage[5])) {
+        coverage[0] = coverage[2] = coverage[4] = 0;
+        coverage[1] = coverage[3] = coverage[5] = -1;
+    }
+
+    int64_t total = (int64_t)(coverage[1] - coverage[0] + 1) * (coverage[3] - coverage[2] + 1) * (coverage[5] - coverage[4] + 1);
+    int8_t overflow = (int8_t)LIBRG_MIN(LIBRG_MAX(total - LIBRG_ENTITY_MAXCHUNKS, 0), INT8_MAX);
+
+    /* entity still covers the same chunks, nothing to update */
+    if (entity->flag_coverage_cached && zpl_memcompare(entity->coverage, coverage, sizeof(coverage)) == 0) {
+        return overflow;
+    }
+
+    for (int i = 0; i < LIBRG_ENTITY_MAXCHUNKS; ++i) entity->chunks[i] = LIBRG_CHUNK_INVALID;
+    zpl_memcopy(entity->coverage, coverage, sizeof(coverage));
+    entity->flag_coverage_cached = LIBRG_TRUE;
+
+    if (total == 0) return LIBRG_OK;
+
+    int64_t row = wld->worldsize.x;
+    int64_t layer = (int64_t)wld->worldsize.x * wld->worldsize.y;
+    int count = 0;
+
+    /* chunk with the center of the box always goes first, so it is kept on overflow */
+    librg_chunk center = ((coverage[4] + coverage[5]) / 2) * layer + ((coverage[2] + coverage[3]) / 2) * row + (coverage[0] + coverage[1]) / 2;
+    entity->chunks[count++] = center;
+
+    for (int32_t z = coverage[4]; z <= coverage[5] && count < LIBRG_ENTITY_MAXCHUNKS; ++z) {
+        for (int32_t y = coverage[2]; y <= coverage[3] && count < LIBRG_ENTITY_MAXCHUNKS; ++y) {
+            for (int32_t x = coverage[0]; x <= coverage[1] && count < LIBRG_ENTITY_MAXCHUNKS; ++x) {
+                librg_chunk id = z * layer + y * row + x;
+                if (id != center) entity->chunks[count++] = id;
+            }
+        }
+    }
+
+    return overflow;
+}
+
 
 int8_t librg_entity_visibility_global_set(librg_world *world, int64_t entity_id, librg_visibility value) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
@@ -348,12 +690,39 @@ int8_t librg_entity_visibility_owner_set(librg_world *world, int64_t entity_id,
     librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
     if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
 
-    if (!entity->flag_visbility_owner_enabled) {
-        entity->flag_visbility_owner_enabled = LIBRG_TRUE;
-        librg_table_i8_init(&entity->owner_visibility_map, wld->allocator);
+    entity->flag_visbility_owner_enabled = LIBRG_TRUE;
+
+    if (entity->owner_visibility_count == LIBRG_VISIBILITY_SPILLED) {
+        librg_table_i8_set(&entity->owner_visibility.map, owner_id, value);
+        return LIBRG_OK;
+    }
+
+    /* first few overrides are kept inline */
+    for (int i = 0; i < entity->owner_visibility_count; ++i) {
+        if (entity->owner_visibility.owners[i] != owner_id) continue;
+        entity->owner_visibility_values[i] = (int8_t)value;
+        return LIBRG_OK;
+    }
+
+    if (entity->owner_visibility_count < LIBRG_ENTITY_VISIBILITY_INLINE) {
+        entity->owner_visibility.owners[entity->owner_visibility_count] = owner_id;
+        entity->owner_visibility_values[entity->owner_visibility_count] = (int8_t)value;
+        entity->owner_visibility_count++;
+        return LIBRG_OK;
     }
 
-    librg_table_i8_set(&entity->owner_visibility_map, owner_id, value);
+    /* and moved into a hash table, once there are too many of them */
+    int64_t owners[LIBRG_ENTITY_VISIBILITY_INLINE];
+    int8_t values[LIBRG_ENTITY_VISIBILITY_INLINE];
+    zpl_memcopy(owners, entity->owner_visibility.owners, sizeof(owners));
+    zpl_memcopy(values, entity->owner_visibility_values, sizeof(values));
+
+    librg_table_i8_init(&entity->owner_visibility.map, wld->allocator);
+    for (int i = 0; i < LIBRG_ENTITY_VISIBILITY_INLINE; ++i)
+        librg_table_i8_set(&entity->owner_visibility.map, owners[i], values[i]);
+
+    librg_table_i8_set(&entity->owner_visibility.map, owner_id, value);
+    entity->owner_visibility_count = LIBRG_VISIBILITY_SPILLED;
 
     return LIBRG_OK;
 }
@@ -365,11 +734,201 @@ int8_t librg_entity_visibility_owner_get(librg_world *world, int64_t entity_id,
     librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
     if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
 
-    if (!entity->flag_visbility_owner_enabled)
-        return LIBRG_VISIBLITY_DEFAULT;
+    return librg_visibility_owner_find(entity, owner_id);
+}
+
+// =======================================================================//
+// !
+// ! Entity attachments
+// !
+// =======================================================================//
+
+int8_t librg_entity_attach(librg_world *world, int64_t entity_id, int64_t parent_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    librg_entity_t *parent = librg_table_ent_get(&wld->entity_map, parent_id);
+    if (entity == NULL || parent == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    /* prevent cycles, entity cannot be attached to itself or its own descendant */
+    for (int64_t id = parent_id; id != LIBRG_ENTITY_INVALID;) {
+        if (id == entity_id) return LIBRG_ENTITY_INVALID;
+        librg_entity_t *ancestor = librg_table_ent_get(&wld->entity_map, id);
+        id = ancestor ? ancestor->parent_id : LIBRG_ENTITY_INVALID;
+    }
+
+    if (entity->parent_id == parent_id) return LIBRG_OK;
+
+    /* move over from the previous parent */
+    librg_entity_unlink(wld, entity_id, entity);
+
+    if (!parent->children) zpl_array_init(parent->children, wld->allocator);
+    zpl_array_append(parent->children, entity_id);
+    entity->parent_id = parent_id;
+
+    return LIBRG_OK;
+}
+
+int8_t librg_entity_detach(librg_world *world, int64_t entity_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    librg_entity_unlink(wld, entity_id, entity);
+    return LIBRG_OK;
+}
+
+int64_t librg_entity_parent_get(librg_world *world, int64_t entity_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    return entity->parent_id;
+}
+
+// =======================================================================//
+// !
+// ! Entity handles
+// !
+// =======================================================================//
+
+/* resolves a handle directly into the entity storage, or returns NULL for stale handles */
+static librg_entity_t *librg_entity_from_handle(librg_world_t *wld, librg_entity_handle handle) {
+    uint32_t index = (uint32_t)(handle & 0xFFFFFFFF);
+    uint32_t generation = (uint32_t)(handle >> 32);
+
+    if (index >= (uint32_t)zpl_array_count(wld->entity_slots)) return NULL;
+
+    librg_entity_slot_t *slot = &wld->entity_slots[index];
+    if (slot->generation != generation || slot->index < 0) return NULL;
+
+    return &wld->entity_map.entries[slot->index].value;
+}
+
+librg_entity_handle librg_entity_handle_get(librg_world *world, int64_t entity_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_HANDLE_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    zpl_isize entry = librg_table_ent__find(&wld->entity_map, entity_id).entry_index;
+    if (entry < 0) return LIBRG_HANDLE_INVALID;
 
-    int8_t *value = librg_table_i8_get(&entity->owner_visibility_map, owner_id);
-    return (value ? *value : LIBRG_VISIBLITY_DEFAULT);
+    librg_entity_t *entity = &wld->entity_map.entries[entry].value;
+
+    /* slots are assigned lazily, so worlds that do not use handles do not pay for them */
+    if (!entity->slot) {
+        uint32_t index = 0;
+
+        if (zpl_array_count(wld->entity_slots_free) > 0) {
+            index = zpl_array_back(wld->entity_slots_free);
+            zpl_array_pop(wld->entity_slots_free);
+        } else {
+            librg_entity_slot_t slot = {1, -1};
+            index = (uint32_t)zpl_array_count(wld->entity_slots);
+            zpl_array_append(wld->entity_slots, slot);
+        }
+
+        wld->entity_slots[index].index = (int32_t)entry;
+        entity->slot = index + 1;
+    }
+
+    return ((librg_entity_handle)wld->entity_slots[entity->slot - 1].generation << 32) | (entity->slot - 1);
+}
+
+int8_t librg_entity_track_handle(librg_world *world, int64_t entity_id, librg_entity_handle *handle) {
+    LIBRG_ASSERT(handle); if (!handle) return LIBRG_NULL_REFERENCE;
+
+    int8_t result = librg_entity_track(world, entity_id);
+    *handle = result == LIBRG_OK ? librg_entity_handle_get(world, entity_id) : LIBRG_HANDLE_INVALID;
+
+    return result;
+}
+
+int8_t librg_entity_handle_valid(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_FALSE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    return librg_entity_from_handle(wld, handle) != NULL;
+}
+
+int64_t librg_entity_handle_id(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    return (int64_t)wld->entity_map.entries[wld->entity_slots[entity->slot - 1].index].key;
+}
+
+int8_t librg_entity_handle_userdata_set(librg_world *world, librg_entity_handle handle, void *data) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->userdata = data;
+    return LIBRG_OK;
+}
+
+void *librg_entity_handle_userdata_get(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return NULL;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return NULL;
+
+    return entity->userdata;
+}
+
+int8_t librg_entity_handle_chunk_set(librg_world *world, librg_entity_handle handle, librg_chunk chunk) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    for (int i = 0; i < LIBRG_ENTITY_MAXCHUNKS; ++i) entity->chunks[i] = LIBRG_CHUNK_INVALID;
+    entity->chunks[0] = chunk;
+    entity->flag_coverage_cached = LIBRG_FALSE;
+
+    return LIBRG_OK;
+}
+
+librg_chunk librg_entity_handle_chunk_get(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    return entity->chunks[0];
+}
+
+int64_t librg_entity_handle_owner_get(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    return entity->owner_id;
+}
+
+int8_t librg_entity_handle_dirty_set(librg_world *world, librg_entity_handle handle) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    librg_entity_t *entity = librg_entity_from_handle(wld, handle);
+    if (entity == NULL) return LIBRG_ENTITY_UNTRACKED;
+
+    entity->dirty_epoch = ++wld->dirty_epoch;
+    return LIBRG_OK;
 }
 
 LIBRG_END_C_DECLS
@@ -32,6 +32,34 @@ ZPL_ALLOCATOR_PROC(librg_allocator_proc) {
     return ptr;
 }
 
+/* routes allocations into the callbacks provided to librg_world_create_ex */
+ZPL_ALLOCATOR_PROC(librg_allocator_callbacks_proc) {
+    librg_allocator *callbacks = (librg_allocator *)allocator_data;
+    void *ptr = NULL;
+
+    zpl_unused(flags);
+
+    switch (type) {
+        case ZPL_ALLOCATION_ALLOC:  { ptr = callbacks->alloc(callbacks->userdata, (size_t)size); } break;
+        case ZPL_ALLOCATION_FREE:   { callbacks->free(callbacks->userdata, old_memory); } break;
+        case ZPL_ALLOCATION_RESIZE: {
+            if (!callbacks->realloc) {
+                zpl_allocator self = { librg_allocator_callbacks_proc, allocator_data };
+                ptr = zpl_default_resize_align(self, old_memory, old_size, size, alignment);
+            } else if (!old_memory) {
+                ptr = callbacks->alloc(callbacks->userdata, (size_t)size);
+            } else if (size == 0) {
+                callbacks->free(callbacks->userdata, old_memory);
+            } else {
+                ptr = callbacks->realloc(callbacks->userdata, old_memory, (size_t)old_size, (size_t)size);
+            }
+        } break;
+        case ZPL_ALLOCATION_FREE_ALL: break;
+    }
+
+    return ptr;
+}
+
 LIBRG_PRIVATE zpl_allocator librg_alloc_wrap() {
     zpl_allocator a = {0};
     a.proc = librg_allocator_proc;
@@ -39,6 +67,285 @@ LIBRG_PRIVATE zpl_allocator librg_alloc_wrap() {
     return a;
 }
 
+// =======================================================================//
+// !
+// ! Internal helpers for owner and baseline storage
+// !
+// =======================================================================//
+
+/* returns per-owner visibility override of the entity, without looking up the entity itself */
+static int8_t librg_visibility_owner_find(librg_entity_t *entity, int64_t owner_id) {
+    if (!entity->flag_visbility_owner_enabled)
+        return LIBRG_VISIBLITY_DEFAULT;
+
+    if (entity->owner_visibility_count == LIBRG_VISIBILITY_SPILLED) {
+        int8_t *value = librg_table_i8_get(&entity->owner_visibility.map, owner_id);
+        return (value ? *value : (int8_t)LIBRG_VISIBLITY_DEFAULT);
+    }
+
+    for (int i = 0; i < entity->owner_visibility_count; ++i) {
+        if (entity->owner_visibility.owners[i] == owner_id)
+            return entity->owner_visibility_values[i];
+    }
+
+    return LIBRG_VISIBLITY_DEFAULT;
+}
+
+static void librg_visibility_owner_destroy(librg_entity_t *entity) {
+    if (!entity->flag_visbility_owner_enabled) return;
+
+    if (entity->owner_visibility_count == LIBRG_VISIBILITY_SPILLED)
+        librg_table_i8_destroy(&entity->owner_visibility.map);
+
+    entity->flag_visbility_owner_enabled = LIBRG_FALSE;
+    entity->owner_visibility_count = 0;
+}
+
+static void librg_baseline_list_free(zpl_array(librg_baseline_t) list) {
+    for (int i = 0; i < zpl_array_count(list); ++i)
+        zpl_array_free(list[i].data);
+
+    zpl_array_free(list);
+}
+
+static void librg_baselines_destroy(librg_table_base *baselines) {
+    for (int i = 0; i < zpl_array_count(baselines->entries); ++i)
+        librg_baseline_list_free(baselines->entries[i].value);
+
+    librg_table_base_destroy(baselines);
+}
+
+static void librg_baseline_remove(librg_table_base *baselines, int64_t entity_id) {
+    zpl_array(librg_baseline_t) *list = librg_table_base_get(baselines, entity_id);
+    if (!list) return;
+
+    librg_baseline_list_free(*list);
+    librg_table_base_remove(baselines, entity_id);
+}
+
+/* returns payload carried by the write with the given sequence */
+static librg_baseline_t *librg_baseline_find(librg_table_base *baselines, int64_t entity_id, int64_t sequence) {
+    zpl_array(librg_baseline_t) *list = librg_table_base_get(baselines, entity_id);
+
+    for (int i = 0; list && i < zpl_array_count(*list); ++i)
+        if ((*list)[i].sequence == sequence) return &(*list)[i];
+
+    return NULL;
+}
+
+/* returns the acknowledged payload, if it is recent enough to be referenced from the write with the given sequence */
+static librg_baseline_t *librg_baseline_acked(librg_table_base *baselines, int64_t entity_id, int64_t sequence) {
+    zpl_array(librg_baseline_t) *list = librg_table_base_get(baselines, entity_id);
+
+    for (int i = 0; list && i < zpl_array_count(*list); ++i) {
+        librg_baseline_t *baseline = &(*list)[i];
+        if (baseline->acked && sequence - baseline->sequence < LIBRG_WORLDWRITE_MAXBASELINES) return baseline;
+    }
+
+    return NULL;
+}
+
+/* frees up the slot of the payload carried by the write with the given sequence */
+static void librg_baseline_drop(librg_table_base *baselines, int64_t entity_id, int64_t sequence) {
+    librg_baseline_t *baseline = librg_baseline_find(baselines, entity_id, sequence);
+    if (!baseline) return;
+
+    baseline->sequence = -1;
+    baseline->acked = LIBRG_FALSE;
+}
+
+/* marks payloads of the write as received by the reader, older ones are not going to be referenced anymore */
+static void librg_baselines_ack(librg_table_base *baselines, int64_t sequence) {
+    for (int i = 0; i < zpl_array_count(baselines->entries); ++i) {
+        zpl_array(librg_baseline_t) list = baselines->entries[i].value;
+        uint8_t found = LIBRG_FALSE;
+
+        for (int j = 0; j < zpl_array_count(list) && !found; ++j)
+            found = list[j].sequence == sequence;
+
+        /* entity was not written within that write, so nothing new is known about it */
+        if (!found) continue;
+
+        for (int j = 0; j < zpl_array_count(list); ++j) {
+            if (list[j].sequence == sequence) {
+                list[j].acked = LIBRG_TRUE;
+            } else if (list[j].sequence < sequence) {
+                list[j].sequence = -1;
+                list[j].acked = LIBRG_FALSE;
+            }
+        }
+    }
+}
+
+/* frees up payloads of the given write on all entities, used when the write is abandoned */
+static void librg_baselines_drop(librg_table_base *baselines, int64_t sequence) {
+    for (int i = 0; i < zpl_array_count(baselines->entries); ++i)
+        librg_baseline_drop(baselines, baselines->entries[i].key, sequence);
+}
+
+/* grows the array through the resize of its allocator, so a realloc callback can extend the block in place */
+/* in case the allocation has failed, array is left untouched */
+static int8_t librg_array_grow_resize(void **array, zpl_isize capacity, zpl_isize element_size) {
+    zpl_array_header *h = ZPL_ARRAY_HEADER(*array);
+    zpl_isize old_size = zpl_size_of(zpl_array_header) + element_size * h->capacity;
+    zpl_isize new_size = zpl_size_of(zpl_array_header) + element_size * capacity;
+
+    zpl_array_header *nh = (zpl_array_header *)zpl_resize(h->allocator, h, old_size, new_size);
+    if (!nh) return LIBRG_FALSE;
+
+    nh->data = (char *)(nh + 1);
+    nh->capacity = capacity;
+    *array = (void *)(nh + 1);
+    return LIBRG_TRUE;
+}
+
+/* same as zpl_array_reserve, used for the byte buffers that keep growing during the writes and reads */
+/* evaluates to LIBRG_FALSE, if the array could not be grown */
+#define LIBRG_ARRAY_RESERVE(x, amount) (zpl_array_capacity(x) >= (amount)                       \
+    || librg_array_grow_resize((void **)&(x),                                                   \
+        zpl_max(ZPL_ARRAY_GROW_FORMULA(zpl_array_capacity(x)), (amount)), zpl_size_of(*(x))))
+
+/* stores payload carried by the write with the given sequence, reusing slots of the ones too old to be referenced */
+static int8_t librg_baseline_store(librg_world_t *wld, librg_table_base *baselines, int64_t entity_id, int64_t sequence, const char *data, size_t size) {
+    zpl_array(librg_baseline_t) *list = librg_table_base_get(baselines, entity_id);
+
+    if (!list) {
+        zpl_array(librg_baseline_t) _list = NULL;
+        zpl_array_init(_list, wld->allocator);
+        librg_table_base_set(baselines, entity_id, _list);
+        list = librg_table_base_get(baselines, entity_id);
+    }
+
+    librg_baseline_t *baseline = librg_baseline_find(baselines, entity_id, sequence);
+
+    for (int i = 0; !baseline && i < zpl_array_count(*list); ++i) {
+        librg_baseline_t *slot = &(*list)[i];
+        if (slot->sequence < 0 || sequence - slot->sequence >= LIBRG_WORLDWRITE_MAXBASELINES) baseline = slot;
+    }
+
+    if (!baseline) {
+        librg_baseline_t _baseline = { -1, LIBRG_FALSE, NULL };
+        zpl_array_init_reserve(_baseline.data, wld->allocator, (zpl_isize)size);
+        zpl_array_append(*list, _baseline);
+        baseline = &(*list)[zpl_array_count(*list) - 1];
+    }
+
+    /* slot is kept as it was, if there is no memory for the new payload */
+    if (!LIBRG_ARRAY_RESERVE(baseline->data, (zpl_isize)size)) return LIBRG_FALSE;
+
+    baseline->sequence = sequence;
+    baseline->acked = LIBRG_FALSE;
+    zpl_array_clear(baseline->data);
+    zpl_array_appendv(baseline->data, data, (zpl_isize)size);
+    return LIBRG_TRUE;
+}
+
+static void librg_owner_reserve(librg_world_t *wld, librg_owner_t *owner) {
+    if (!wld->reserve_per_owner) return;
+
+    LIBRG_TABLE_RESERVE(librg_table_i64_, &owner->snapshot, wld->reserve_per_owner);
+    LIBRG_TABLE_RESERVE(librg_table_i64_, &owner->sent_epochs, wld->reserve_per_owner);
+    LIBRG_TABLE_RESERVE(librg_table_f32_, &owner->priorities, wld->reserve_per_owner);
+    LIBRG_TABLE_RESERVE(librg_table_base_, &owner->baselines, wld->reserve_per_owner);
+
+    if (!owner->spare.hashes) librg_table_i64_init(&owner->spare, wld->allocator);
+    LIBRG_TABLE_RESERVE(librg_table_i64_, &owner->spare, wld->reserve_per_owner);
+}
+
+/* hands out a cleared snapshot table, reusing the spare one if it is available */
+static void librg_snapshot_acquire(librg_world_t *wld, librg_owner_t *owner, librg_table_i64 *snapshot) {
+    if (owner->spare.hashes) {
+        *snapshot = owner->spare;
+        zpl_zero_item(&owner->spare);
+        return;
+    }
+
+    librg_table_i64_init(snapshot, wld->allocator);
+    if (wld->reserve_per_owner) LIBRG_TABLE_RESERVE(librg_table_i64_, snapshot, wld->reserve_per_owner);
+}
+
+/* keeps a no longer needed snapshot table as a spare one, or frees it up */
+static void librg_snapshot_release(librg_owner_t *owner, librg_table_i64 *snapshot) {
+    if (owner->spare.hashes) {
+        librg_table_i64_destroy(snapshot);
+    } else {
+        librg_table_i64_clear(snapshot);
+        owner->spare = *snapshot;
+    }
+
+    zpl_zero_item(snapshot);
+}
+
+static void librg_write_cursor_reset(librg_owner_t *owner) {
+    librg_write_cursor_t *cursor = &owner->cursor;
+    if (!cursor->active) return;
+
+    /* payloads of the abandoned write might have never reached the reader */
+    librg_baselines_drop(&owner->baselines, owner->sequence + 1);
+
+    librg_snapshot_release(owner, &cursor->next_snapshot);
+    cursor->results = NULL;
+    cursor->active = LIBRG_FALSE;
+}
+
+/* capacity of the zpl array, including its header */
+#define LIBRG_MEMORY_ARRAY(a) ((a) ? (uint64_t)(zpl_array_capacity(a) * zpl_size_of(*(a)) + zpl_size_of(zpl_array_header)) : 0)
+#define LIBRG_MEMORY_COUNT(a) ((a) ? (uint64_t)zpl_array_count(a) : 0)
+#define LIBRG_MEMORY_TABLE(h) (LIBRG_MEMORY_ARRAY((h)->hashes) + LIBRG_MEMORY_ARRAY((h)->entries))
+
+/* updates the sampled maximum of a single owner snapshot, called each time a write is finished */
+static void librg_memory_snapshot_sample(librg_world_t *wld, librg_table_i64 *snapshot) {
+    librg_memory_usage *sampled = &wld->memory_sampled.largest_snapshot;
+    sampled->sampled_max_bytes = zpl_max(sampled->sampled_max_bytes, LIBRG_MEMORY_TABLE(snapshot));
+    sampled->sampled_max_count = zpl_max(sampled->sampled_max_count, LIBRG_MEMORY_COUNT(snapshot->entries));
+}
+
+static librg_owner_t *librg_owner_create(librg_world_t *wld, int64_t owner_id) {
+    librg_owner_t _owner = {0};
+    librg_table_own_set(&wld->owner_map, owner_id, _owner);
+
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+    librg_table_i64_init(&owner->snapshot, wld->allocator);
+    librg_table_base_init(&owner->baselines, wld->allocator);
+    librg_table_f32_init(&owner->priorities, wld->allocator);
+    librg_table_i64_init(&owner->sent_epochs, wld->allocator);
+    zpl_array_init(owner->cursor.pending, wld->allocator);
+    zpl_array_init(owner->cursor.batch_ids, wld->allocator);
+    zpl_array_init(owner->cursor.batch_sizes, wld->allocator);
+    zpl_array_init(owner->cursor.batch_buffers, wld->allocator);
+    zpl_array_init(owner->cursor.batch_data, wld->allocator);
+    zpl_array_init(owner->blocks, wld->allocator);
+    zpl_array_init(owner->unacked, wld->allocator);
+    librg_owner_reserve(wld, owner);
+
+    return owner;
+}
+
+static void librg_owner_destroy(librg_world_t *wld, librg_owner_t *owner) {
+    librg_write_cursor_reset(owner);
+    librg_table_i64_destroy(&owner->snapshot);
+    librg_table_i64_destroy(&owner->spare);
+    librg_baselines_destroy(&owner->baselines);
+    librg_table_f32_destroy(&owner->priorities);
+    librg_table_i64_destroy(&owner->sent_epochs);
+    zpl_free(wld->allocator, owner->cursor.results_buffer);
+    zpl_array_free(owner->cursor.pending);
+    zpl_array_free(owner->cursor.batch_ids);
+    zpl_array_free(owner->cursor.batch_sizes);
+    zpl_array_free(owner->cursor.batch_buffers);
+    zpl_array_free(owner->cursor.batch_data);
+
+    for (int i = 0; i < zpl_array_count(owner->blocks); ++i)
+        zpl_free(wld->allocator, owner->blocks[i].base);
+
+    zpl_array_free(owner->blocks);
+
+    for (int i = 0; i < zpl_array_count(owner->unacked); ++i)
+        librg_table_i64_destroy(&owner->unacked[i].snapshot);
+
+    zpl_array_free(owner->unacked);
+}
+
 // =======================================================================//
 // !
 // ! Context methods
@@ -50,13 +357,31 @@ uint32_t librg_version() {
 }
 
 librg_world *librg_world_create() {
-    librg_world_t *wld = (librg_world_t *)LIBRG_MEM_ALLOC(sizeof(librg_world_t));
+    return librg_world_create_ex(NULL);
+}
+
+librg_world *librg_world_create_ex(const librg_allocator *allocator) {
+    LIBRG_ASSERT(!allocator || (allocator->alloc && allocator->free));
+    if (allocator && (!allocator->alloc || !allocator->free)) return NULL;
+
+    librg_world_t *wld = allocator
+        ? (librg_world_t *)allocator->alloc(allocator->userdata, sizeof(librg_world_t))
+        : (librg_world_t *)LIBRG_MEM_ALLOC(sizeof(librg_world_t));
+
+    if (!wld) return NULL;
     zpl_memset(wld, 0, sizeof(librg_world_t));
 
     /* setup initials */
     wld->valid = LIBRG_TRUE;
     wld->allocator = librg_alloc_wrap();
 
+    /* allocator points to the callbacks stored within the world, so they live as long as the world does */
+    if (allocator) {
+        wld->allocator_callbacks = *allocator;
+        wld->allocator.proc = librg_allocator_callbacks_proc;
+        wld->allocator.data = &wld->allocator_callbacks;
+    }
+
     /* setup defaults */
     librg_config_chunksize_set((librg_world *)wld, 16, 16, 16);
     librg_config_chunkamount_set((librg_world *)wld, 256, 256, 256);
@@ -64,11 +389,32 @@ librg_world *librg_world_create() {
 
     /* initialize internal structs */
     librg_table_ent_init(&wld->entity_map, wld->allocator);
-    librg_table_tbl_init(&wld->owner_map, wld->allocator);
+    librg_table_own_init(&wld->owner_map, wld->allocator);
     zpl_random_init(&wld->random);
     zpl_array_init(wld->owner_entity_pairs, wld->allocator);
+    zpl_array_init(wld->entity_slots, wld->allocator);
+    zpl_array_init(wld->entity_slots_free, wld->allocator);
 
     librg_table_tbl_init(&wld->dimensions, wld->allocator);
+    zpl_array_init(wld->query_origins, wld->allocator);
+    zpl_array_init(wld->priority_origins, wld->allocator);
+    zpl_array_init(wld->priority_order, wld->allocator);
+    librg_table_i64_init(&wld->owner_interests, wld->allocator);
+
+    for (int i = 0; i <= LIBRG_WRITE_REMOVE; ++i)
+        librg_table_cache_init(&wld->cache_map[i], wld->allocator);
+    zpl_array_init(wld->cache_arena, wld->allocator);
+
+    librg_table_bases_init(&wld->read_baselines, wld->allocator);
+    zpl_array_init(wld->delta_scratch, wld->allocator);
+
+    zpl_array_init(wld->read_batch_ids, wld->allocator);
+    zpl_array_init(wld->read_batch_sizes, wld->allocator);
+    zpl_array_init(wld->read_batch_buffers, wld->allocator);
+    zpl_array_init(wld->read_batch_data, wld->allocator);
+
+    zpl_array_init(wld->compression_dictionary, wld->allocator);
+    zpl_array_init(wld->compression_scratch, wld->allocator);
 
     return (librg_world *)wld;
 }
@@ -81,10 +427,9 @@ int8_t librg_world_destroy(librg_world *world) {
         for (int i = 0; i < zpl_array_count(wld->entity_map.entries); ++i) {
             librg_entity_t *entity = &wld->entity_map.entries[i].value;
 
-            if (entity->flag_visbility_owner_enabled) {
-                entity->flag_visbility_owner_enabled = LIBRG_FALSE;
-                librg_table_i8_destroy(&entity->owner_visibility_map);
-            }
+            librg_visibility_owner_destroy(entity);
+
+            if (entity->children) zpl_array_free(entity->children);
         }
 
         librg_table_ent_destroy(&wld->entity_map);
@@ -92,18 +437,51 @@ int8_t librg_world_destroy(librg_world *world) {
 
     {/* free up owners */
         for (int i = 0; i < zpl_array_count(wld->owner_map.entries); ++i)
-            librg_table_i64_destroy(&wld->owner_map.entries[i].value);
+            librg_owner_destroy(wld, &wld->owner_map.entries[i].value);
 
-        librg_table_tbl_destroy(&wld->owner_map);
+        librg_table_own_destroy(&wld->owner_map);
     }
 
     zpl_array_free(wld->owner_entity_pairs);
+    zpl_array_free(wld->entity_slots);
+    zpl_array_free(wld->entity_slots_free);
+    for (int i = 0; i < zpl_array_count(wld->dimensions.entries); ++i)
+        librg_table_i64_destroy(&wld->dimensions.entries[i].value);
     librg_table_tbl_destroy(&wld->dimensions);
+    zpl_array_free(wld->query_origins);
+    zpl_array_free(wld->priority_origins);
+    zpl_array_free(wld->priority_order);
+    zpl_free(wld->allocator, wld->write_results);
+    librg_table_i64_destroy(&wld->owner_interests);
+
+    for (int i = 0; i <= LIBRG_WRITE_REMOVE; ++i)
+        librg_table_cache_destroy(&wld->cache_map[i]);
+    zpl_array_free(wld->cache_arena);
+
+    for (int i = 0; i < zpl_array_count(wld->read_baselines.entries); ++i)
+        librg_baselines_destroy(&wld->read_baselines.entries[i].value);
+
+    librg_table_bases_destroy(&wld->read_baselines);
+    zpl_array_free(wld->delta_scratch);
+
+    zpl_array_free(wld->read_batch_ids);
+    zpl_array_free(wld->read_batch_sizes);
+    zpl_array_free(wld->read_batch_buffers);
+    zpl_array_free(wld->read_batch_data);
+
+    zpl_array_free(wld->compression_dictionary);
+    zpl_array_free(wld->compression_scratch);
 
     /* mark it invalid */
     wld->valid = LIBRG_FALSE;
 
-    LIBRG_MEM_FREE(world);
+    if (wld->allocator.proc == librg_allocator_callbacks_proc) {
+        librg_allocator callbacks = wld->allocator_callbacks;
+        callbacks.free(callbacks.userdata, world);
+    } else {
+        LIBRG_MEM_FREE(world);
+    }
+
     return LIBRG_OK;
 }
 
@@ -132,6 +510,202 @@ int64_t librg_world_entities_tracked(librg_world *world) {
     return zpl_array_count(wld->entity_map.entries);
 }
 
+int8_t librg_world_tick(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* drop all payloads cached during the previous tick */
+    for (int i = 0; i <= LIBRG_WRITE_REMOVE; ++i)
+        librg_table_cache_clear(&wld->cache_map[i]);
+    zpl_array_clear(wld->cache_arena);
+
+    return LIBRG_OK;
+}
+
+int8_t librg_world_reserve(librg_world *world, size_t entities, size_t owners, size_t entities_per_owner) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    LIBRG_TABLE_RESERVE(librg_table_ent_, &wld->entity_map, entities);
+    LIBRG_TABLE_RESERVE(librg_table_own_, &wld->owner_map, owners);
+    /* there is a pair for each owned entity, at most one per entity */
+    zpl_array_reserve(wld->owner_entity_pairs, (zpl_isize)entities);
+
+    for (int i = 0; i <= LIBRG_WRITE_REMOVE; ++i)
+        LIBRG_TABLE_RESERVE(librg_table_cache_, &wld->cache_map[i], entities);
+
+    /* applied to existing owners right away, and to the new ones on creation */
+    wld->reserve_per_owner = entities_per_owner;
+
+    for (int i = 0; i < zpl_array_count(wld->owner_map.entries); ++i)
+        librg_owner_reserve(wld, &wld->owner_map.entries[i].value);
+
+    return LIBRG_OK;
+}
+
+int8_t librg_world_interest_set(librg_world *world, int64_t owner_id, uint64_t layers) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    if (layers == LIBRG_LAYERS_ALL) {
+        librg_table_i64_remove(&wld->owner_interests, owner_id);
+    } else {
+        librg_table_i64_set(&wld->owner_interests, owner_id, (int64_t)layers);
+    }
+
+    return LIBRG_OK;
+}
+
+uint64_t librg_world_interest_get(librg_world *world, int64_t owner_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_LAYERS_ALL;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    int64_t *layers = librg_table_i64_get(&wld->owner_interests, owner_id);
+    return layers ? (uint64_t)*layers : LIBRG_LAYERS_ALL;
+}
+
+static void librg_memory_baselines(librg_memory_usage *usage, librg_table_base *baselines) {
+    usage->bytes += LIBRG_MEMORY_TABLE(baselines);
+
+    for (int i = 0; i < zpl_array_count(baselines->entries); ++i) {
+        zpl_array(librg_baseline_t) list = baselines->entries[i].value;
+        usage->bytes += LIBRG_MEMORY_ARRAY(list);
+        usage->count += LIBRG_MEMORY_COUNT(list);
+
+        for (int j = 0; j < zpl_array_count(list); ++j)
+            usage->bytes += LIBRG_MEMORY_ARRAY(list[j].data);
+    }
+}
+
+static void librg_memory_snapshot(librg_memory_usage *usage, librg_table_i64 *snapshot) {
+    usage->bytes += LIBRG_MEMORY_TABLE(snapshot);
+    usage->count += LIBRG_MEMORY_COUNT(snapshot->entries);
+}
+
+static void librg_memory_buffer(librg_memory_usage *usage, uint64_t bytes, uint64_t used) {
+    usage->bytes += bytes;
+    usage->count += used;
+}
+
+static void librg_memory_sample(librg_memory_usage *usage, librg_memory_usage *sampled) {
+    sampled->sampled_max_bytes = zpl_max(sampled->sampled_max_bytes, usage->bytes);
+    sampled->sampled_max_count = zpl_max(sampled->sampled_max_count, usage->count);
+    usage->sampled_max_bytes = sampled->sampled_max_bytes;
+    usage->sampled_max_count = sampled->sampled_max_count;
+}
+
+int8_t librg_world_memory_stats(librg_world *world, librg_memory_stats *stats) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(stats); if (!stats) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    zpl_zero_item(stats);
+
+    {/* entities, their attachments and visibility overrides */
+        stats->entities.bytes = LIBRG_MEMORY_TABLE(&wld->entity_map);
+        stats->entities.count = LIBRG_MEMORY_COUNT(wld->entity_map.entries);
+
+        for (int i = 0; i < zpl_array_count(wld->entity_map.entries); ++i) {
+            librg_entity_t *entity = &wld->entity_map.entries[i].value;
+            stats->entities.bytes += LIBRG_MEMORY_ARRAY(entity->children);
+
+            if (entity->flag_visbility_owner_enabled && entity->owner_visibility_count == LIBRG_VISIBILITY_SPILLED) {
+                stats->visibility.bytes += LIBRG_MEMORY_TABLE(&entity->owner_visibility.map);
+                stats->visibility.count += LIBRG_MEMORY_COUNT(entity->owner_visibility.map.entries);
+            }
+        }
+
+        stats->handles.bytes = LIBRG_MEMORY_ARRAY(wld->entity_slots) + LIBRG_MEMORY_ARRAY(wld->entity_slots_free);
+        stats->handles.count = LIBRG_MEMORY_COUNT(wld->entity_slots);
+
+        stats->pairs.bytes = LIBRG_MEMORY_ARRAY(wld->owner_entity_pairs);
+        stats->pairs.count = LIBRG_MEMORY_COUNT(wld->owner_entity_pairs);
+    }
+
+    {/* query indices */
+        stats->query.bytes = LIBRG_MEMORY_TABLE(&wld->dimensions)
+            + LIBRG_MEMORY_ARRAY(wld->query_origins)
+            + LIBRG_MEMORY_TABLE(&wld->owner_interests);
+
+        for (int i = 0; i < zpl_array_count(wld->dimensions.entries); ++i) {
+            stats->query.bytes += LIBRG_MEMORY_TABLE(&wld->dimensions.entries[i].value);
+            stats->query.count += LIBRG_MEMORY_COUNT(wld->dimensions.entries[i].value.entries);
+        }
+    }
+
+    {/* owners and their per-owner tables */
+        stats->owners.bytes = LIBRG_MEMORY_TABLE(&wld->owner_map);
+        stats->owners.count = LIBRG_MEMORY_COUNT(wld->owner_map.entries);
+
+        for (int i = 0; i < zpl_array_count(wld->owner_map.entries); ++i) {
+            librg_owner_t *owner = &wld->owner_map.entries[i].value;
+            librg_write_cursor_t *cursor = &owner->cursor;
+
+            stats->owners.bytes += LIBRG_MEMORY_TABLE(&owner->priorities)
+                + LIBRG_MEMORY_TABLE(&owner->sent_epochs)
+                + LIBRG_MEMORY_ARRAY(owner->unacked);
+
+            librg_memory_snapshot(&stats->snapshots, &owner->snapshot);
+            librg_memory_snapshot(&stats->snapshots, &owner->spare);
+            librg_memory_snapshot(&stats->snapshots, &cursor->next_snapshot);
+
+            for (int j = 0; j < zpl_array_count(owner->unacked); ++j)
+                librg_memory_snapshot(&stats->snapshots, &owner->unacked[j].snapshot);
+
+            uint64_t snapshot_count = LIBRG_MEMORY_COUNT(owner->snapshot.entries);
+            if (snapshot_count >= stats->largest_snapshot.count) {
+                stats->largest_snapshot.bytes = LIBRG_MEMORY_TABLE(&owner->snapshot);
+                stats->largest_snapshot.count = snapshot_count;
+            }
+
+            librg_memory_baselines(&stats->baselines, &owner->baselines);
+
+            librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(cursor->pending), LIBRG_MEMORY_COUNT(cursor->pending));
+            librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(cursor->batch_data), LIBRG_MEMORY_COUNT(cursor->batch_data));
+            librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(cursor->batch_ids)
+                + LIBRG_MEMORY_ARRAY(cursor->batch_sizes) + LIBRG_MEMORY_ARRAY(cursor->batch_buffers), 0);
+            librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(owner->blocks), 0);
+
+            for (int j = 0; j < zpl_array_count(owner->blocks); ++j)
+                librg_memory_buffer(&stats->buffers, owner->blocks[j].len, 0);
+        }
+
+        for (int i = 0; i < zpl_array_count(wld->read_baselines.entries); ++i)
+            librg_memory_baselines(&stats->baselines, &wld->read_baselines.entries[i].value);
+
+        stats->baselines.bytes += LIBRG_MEMORY_TABLE(&wld->read_baselines);
+    }
+
+    {/* world-wide buffers */
+        for (int i = 0; i <= LIBRG_WRITE_REMOVE; ++i)
+            librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_TABLE(&wld->cache_map[i]), 0);
+
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->cache_arena), LIBRG_MEMORY_COUNT(wld->cache_arena));
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->delta_scratch), LIBRG_MEMORY_COUNT(wld->delta_scratch));
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->priority_origins) + LIBRG_MEMORY_ARRAY(wld->priority_order), 0);
+        if (wld->write_results) librg_memory_buffer(&stats->buffers, LIBRG_WORLDWRITE_MAXQUERY * sizeof(int64_t), 0);
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->read_batch_data), LIBRG_MEMORY_COUNT(wld->read_batch_data));
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->read_batch_ids)
+            + LIBRG_MEMORY_ARRAY(wld->read_batch_sizes) + LIBRG_MEMORY_ARRAY(wld->read_batch_buffers), 0);
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->compression_dictionary), LIBRG_MEMORY_COUNT(wld->compression_dictionary));
+        librg_memory_buffer(&stats->buffers, LIBRG_MEMORY_ARRAY(wld->compression_scratch), LIBRG_MEMORY_COUNT(wld->compression_scratch));
+    }
+
+    stats->total.bytes = sizeof(librg_world_t)
+        + stats->entities.bytes + stats->handles.bytes + stats->visibility.bytes
+        + stats->pairs.bytes + stats->query.bytes + stats->owners.bytes
+        + stats->snapshots.bytes + stats->baselines.bytes + stats->buffers.bytes;
+
+    /* merge current values into the maximums sampled by the world */
+    librg_memory_usage *usage = (librg_memory_usage *)stats;
+    librg_memory_usage *sampled = (librg_memory_usage *)&wld->memory_sampled;
+
+    for (size_t i = 0; i < sizeof(librg_memory_stats) / sizeof(librg_memory_usage); ++i)
+        librg_memory_sample(&usage[i], &sampled[i]);
+
+    return LIBRG_OK;
+}
+
+
 // =======================================================================//
 // !
 // ! Runtime configuration
@@ -192,6 +766,106 @@ int8_t librg_config_chunkoffset_get(librg_world *world, int16_t *x, int16_t *y,
     return LIBRG_OK;
 }
 
+int8_t librg_config_deltaencoding_set(librg_world *world, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->delta_enabled = value ? LIBRG_TRUE : LIBRG_FALSE;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_deltaencoding_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->delta_enabled;
+}
+
+int8_t librg_config_prioritization_set(librg_world *world, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->priority_enabled = value ? LIBRG_TRUE : LIBRG_FALSE;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_prioritization_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->priority_enabled;
+}
+
+int8_t librg_config_dirtytracking_set(librg_world *world, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->dirty_enabled = value ? LIBRG_TRUE : LIBRG_FALSE;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_dirtytracking_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->dirty_enabled;
+}
+
+int8_t librg_config_acknowledgement_set(librg_world *world, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->ack_enabled = value ? LIBRG_TRUE : LIBRG_FALSE;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_acknowledgement_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->ack_enabled;
+}
+
+int8_t librg_config_wireformat_set(librg_world *world, librg_wireformat value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->wireformat = (value == LIBRG_WIREFORMAT_COMPACT) ? LIBRG_WIREFORMAT_COMPACT : LIBRG_WIREFORMAT_DEFAULT;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_wireformat_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->wireformat;
+}
+
+int8_t librg_config_compression_set(librg_world *world, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    wld->compression_enabled = value ? LIBRG_TRUE : LIBRG_FALSE;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_compression_get(librg_world *world) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    return wld->compression_enabled;
+}
+
+int8_t librg_config_compression_codec_set(librg_world *world, librg_codec_fn encode, librg_codec_fn decode) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* codecs go in pairs, NULL restores the built-in one */
+    if (!encode || !decode) encode = decode = NULL;
+
+    wld->compression_encode = encode;
+    wld->compression_decode = decode;
+    return LIBRG_OK;
+}
+
+int8_t librg_config_compression_dictionary_set(librg_world *world, const char *dictionary, size_t size) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    zpl_array_clear(wld->compression_dictionary);
+    if (dictionary && size > 0) zpl_array_appendv(wld->compression_dictionary, dictionary, (zpl_isize)size);
+
+    return LIBRG_OK;
+}
+
 // =======================================================================//
 // !
 // ! Events
@@ -223,6 +897,68 @@ int8_t librg_event_remove(librg_world *world, librg_event_type id) {
     return LIBRG_OK;
 }
 
+int8_t librg_event_batch_set(librg_world *world, librg_event_type id, librg_event_batch_fn handler, size_t slot_size) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* only write and read events can be batched */
+    if (id > LIBRG_READ_REMOVE) {
+        return LIBRG_EVENT_INVALID;
+    }
+
+    wld->batch_slot_size[id] = slot_size;
+
+    if (wld->batch_handlers[id]) {
+        wld->batch_handlers[id] = handler;
+        return LIBRG_HANDLER_REPLACED;
+    }
+
+    wld->batch_handlers[id] = handler;
+    return LIBRG_OK;
+}
+
+int8_t librg_event_batch_remove(librg_world *world, librg_event_type id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    if (id > LIBRG_READ_REMOVE) {
+        return LIBRG_EVENT_INVALID;
+    }
+
+    if (!wld->batch_handlers[id]) {
+        return LIBRG_HANDLER_EMPTY;
+    }
+
+    wld->batch_handlers[id] = NULL;
+    wld->batch_slot_size[id] = 0;
+    return LIBRG_OK;
+}
+
+int8_t librg_event_cache_set(librg_world *world, librg_event_type id, uint8_t value) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* only write events can be cached */
+    if (id > LIBRG_WRITE_REMOVE) {
+        return LIBRG_EVENT_INVALID;
+    }
+
+    wld->cache_enabled[id] = value ? LIBRG_TRUE : LIBRG_FALSE;
+    librg_table_cache_clear(&wld->cache_map[id]);
+    return LIBRG_OK;
+}
+
+int8_t librg_event_cache_get(librg_world *world, librg_event_type id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    if (id > LIBRG_WRITE_REMOVE) {
+        return LIBRG_EVENT_INVALID;
+    }
+
+    return wld->cache_enabled[id];
+}
+
 int8_t librg_event_type_get(librg_world *world, librg_event *event) {
     LIBRG_ASSERT(event); if (!event) return LIBRG_EVENT_INVALID;
     zpl_unused(world);
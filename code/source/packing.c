@@ -23,6 +23,9 @@ LIBRG_BEGIN_C_DECLS
 #define LIBRG_SEGVAL_SIZE 12
 #endif
 
+/* largest payload a single segment value can carry */
+#define LIBRG_SEGVAL_MAXSIZE LIBRG_MIN((uint64_t)(LIBRG_WORLDWRITE_DATATYPE)~(LIBRG_WORLDWRITE_DATATYPE)0, (uint64_t)ZPL_I32_MAX)
+
 LIBRG_PRAGMA(pack(push, 1));
 typedef struct {
     uint64_t id;
@@ -32,7 +35,7 @@ typedef struct {
 
 typedef struct {
     uint8_t  type;
-    uint8_t  unused_;
+    uint8_t  flags;
     uint16_t amount;
     uint32_t size;
 } librg_segment_t;
@@ -41,51 +44,600 @@ LIBRG_PRAGMA(pack(pop));
 LIBRG_STATIC_ASSERT(sizeof(librg_segval_t) == LIBRG_SEGVAL_SIZE, "packed librg_segval_t should have a valid size");
 LIBRG_STATIC_ASSERT(sizeof(librg_segment_t) == LIBRG_SEGMENT_SIZE, "packed librg_segment_t should have a valid size");
 
+/* segment flags */
+#define LIBRG_SEGMENT_DELTA 0x01 /* segval payloads are delta-encoded against per-owner baselines */
+#define LIBRG_SEGMENT_RESEND 0x02 /* written in the acknowledgement mode, values might repeat the unacknowledged ones */
+
+/* snapshot values, written entities are marked in the acknowledgement mode, and applied once the write is acknowledged */
+#define LIBRG_SNAPSHOT_KNOWN 1
+#define LIBRG_SNAPSHOT_ALIVE 2 /* set on the last snapshot, for entities that are still visible */
+#define LIBRG_SNAPSHOT_WRITTEN 0x04 /* payload of the entity was written */
+#define LIBRG_SNAPSHOT_OWNER 0x08 /* ownership was written, with its token in the upper bits */
+#define LIBRG_SNAPSHOT_TOKEN_SHIFT 16
+
+/* compact wire format, marked by the high bit of the segment type */
+#define LIBRG_SEGMENT_COMPACT 0x80
+
+/* upper bounds of the compact headers: type, flags, varint amount, varint size */
+#define LIBRG_SEGMENT_COMPACT_MAX (1 + 1 + 3 + 5)
+/* and zigzag varint id delta, varint size with token bit, varint token */
+#define LIBRG_SEGVAL_COMPACT_MAX (10 + 5 + 3)
+
+// =======================================================================//
+// !
+// ! Delta encoding
+// !
+// =======================================================================//
+
+static LIBRG_ALWAYS_INLINE uint64_t librg_zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static LIBRG_ALWAYS_INLINE int64_t librg_zigzag_decode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * Delta is encoded as a target size, followed by a list of (skip, literal) runs.
+ * Skipped bytes are the ones that did not change compared to the baseline,
+ * literal bytes are stored xored against the baseline. Missing baseline bytes are considered zeros.
+ */
+static int32_t librg_delta_encode(const char *base, size_t base_size, const char *data, size_t size, char *out, size_t limit) {
+    #define librg_delta_byte(i) ((char)(data[i] ^ ((i) < base_size ? base[i] : 0)))
+
+    char header[20];
+    size_t written = 0;
+    size_t pos = 0;
+
+    size_t hsize = librg_varint_write(header, size);
+    if (hsize > limit) return LIBRG_WRITE_REJECT;
+    zpl_memcopy(out, header, hsize);
+    written += hsize;
+
+    while (pos < size) {
+        size_t skip = 0, literal = 0;
+        while (pos + skip < size && librg_delta_byte(pos + skip) == 0) skip++;
+
+        /* extend literal, till we meet at least 3 unchanged bytes in a row */
+        size_t start = pos + skip;
+        while (start + literal < size) {
+            size_t i = start + literal;
+            if (i + 2 < size && librg_delta_byte(i) == 0 && librg_delta_byte(i + 1) == 0 && librg_delta_byte(i + 2) == 0) break;
+            if (i + 2 >= size && librg_delta_byte(i) == 0 && (i + 1 >= size || librg_delta_byte(i + 1) == 0)) break;
+            literal++;
+        }
+
+        hsize = librg_varint_write(header, skip);
+        hsize += librg_varint_write(header + hsize, literal);
+        if (written + hsize + literal > limit) return LIBRG_WRITE_REJECT;
+
+        zpl_memcopy(out + written, header, hsize);
+        written += hsize;
+
+        for (size_t i = start; i < start + literal; ++i)
+            out[written++] = librg_delta_byte(i);
+
+        pos = start + literal;
+    }
+
+    #undef librg_delta_byte
+    return (int32_t)written;
+}
+
+static int32_t librg_delta_decode(const char *base, size_t base_size, const char *in, size_t in_size, char *out, size_t limit) {
+    uint64_t size = 0, skip = 0, literal = 0;
+    size_t read = librg_varint_read(in, in_size, &size);
+    size_t pos = 0;
+
+    if (!read || size > limit) return LIBRG_READ_INVALID;
+
+    while (pos < size) {
+        size_t r1 = librg_varint_read(in + read, in_size - read, &skip); read += r1;
+        size_t r2 = r1 ? librg_varint_read(in + read, in_size - read, &literal) : 0; read += r2;
+
+        if (!r1 || !r2 || pos + skip + literal > size || read + literal > in_size) return LIBRG_READ_INVALID;
+        if (skip == 0 && literal == 0) return LIBRG_READ_INVALID;
+
+        for (size_t i = pos; i < pos + skip; ++i)
+            out[i] = i < base_size ? base[i] : 0;
+
+        pos += skip;
+
+        for (size_t i = pos; i < pos + literal; ++i)
+            out[i] = (char)(in[read++] ^ (i < base_size ? base[i] : 0));
+
+        pos += literal;
+    }
+
+    if (read != in_size) return LIBRG_READ_INVALID;
+    return (int32_t)size;
+}
+
+// =======================================================================//
+// !
+// ! Segment headers
+// !
+// =======================================================================//
+
+/**
+ * Compact segment header: type (with the compact bit set), flags, varint amount and varint size.
+ * Compact segval header: zigzag varint delta of the id against the previous segval (ids are sorted),
+ * varint of the payload size shifted left by 1, with the lowest bit marking presence of the varint token.
+ */
+static size_t librg_segment_encode(char *out, uint8_t type, uint8_t flags, uint16_t amount, uint32_t size) {
+    size_t written = 0;
+
+    out[written++] = (char)(type | LIBRG_SEGMENT_COMPACT);
+    out[written++] = (char)flags;
+    written += librg_varint_write(out + written, amount);
+    written += librg_varint_write(out + written, size);
+
+    return written;
+}
+
+static size_t librg_segval_encode(char *out, int64_t prev_id, int64_t id, uint16_t token, size_t size) {
+    size_t written = librg_varint_write(out, librg_zigzag_encode((int64_t)((uint64_t)id - (uint64_t)prev_id)));
+    written += librg_varint_write(out + written, ((uint64_t)size << 1) | (token ? 1 : 0));
+
+    if (token) {
+        written += librg_varint_write(out + written, token);
+    }
+
+    return written;
+}
+
+/* returns size of the header, or 0 if it cannot be read */
+static size_t librg_segment_decode(const char *in, size_t size, librg_segment_t *seg, uint8_t *compact) {
+    if (size == 0) return 0;
+    *compact = ((uint8_t)in[0] & LIBRG_SEGMENT_COMPACT) != 0;
+
+    if (!*compact) {
+        if (size <= sizeof(librg_segment_t)) return 0;
+        zpl_memcopy(seg, in, sizeof(librg_segment_t));
+        return sizeof(librg_segment_t);
+    }
+
+    uint64_t amount = 0, value_size = 0;
+    if (size < 2) return 0;
+
+    size_t read = 2;
+    size_t r1 = librg_varint_read(in + read, size - read, &amount); read += r1;
+    size_t r2 = r1 ? librg_varint_read(in + read, size - read, &value_size) : 0; read += r2;
+    if (!r1 || !r2 || amount > ZPL_U16_MAX || value_size > ZPL_U32_MAX) return 0;
+
+    seg->type = (uint8_t)in[0] & ~LIBRG_SEGMENT_COMPACT;
+    seg->flags = (uint8_t)in[1];
+    seg->amount = (uint16_t)amount;
+    seg->size = (uint32_t)value_size;
+
+    return read;
+}
+
+/* val->id should contain id of the previous segval within the segment (or 0) */
+static size_t librg_segval_decode(const char *in, size_t size, uint8_t compact, librg_segval_t *val) {
+    if (!compact) {
+        if (size < sizeof(librg_segval_t)) return 0;
+        zpl_memcopy(val, in, sizeof(librg_segval_t));
+        return sizeof(librg_segval_t);
+    }
+
+    uint64_t delta = 0, value_size = 0, token = 0;
+    size_t read = librg_varint_read(in, size, &delta);
+    size_t r1 = read ? librg_varint_read(in + read, size - read, &value_size) : 0; read += r1;
+    if (!read || !r1) return 0;
+
+    if (value_size & 1) {
+        size_t r2 = librg_varint_read(in + read, size - read, &token); read += r2;
+        if (!r2 || token > ZPL_U16_MAX) return 0;
+    }
+
+    value_size >>= 1;
+    if ((uint64_t)(LIBRG_WORLDWRITE_DATATYPE)value_size != value_size) return 0;
+
+    val->id = val->id + (uint64_t)librg_zigzag_decode(delta);
+    val->token = (uint16_t)token;
+    val->size = (LIBRG_WORLDWRITE_DATATYPE)value_size;
+
+    return read;
+}
+
 // =======================================================================//
 // !
 // ! World data packing method
 // !
 // =======================================================================//
 
-int32_t librg_world_write(librg_world *world, int64_t owner_id, uint8_t chunk_radius, char *buffer, size_t *size, void *userdata) {
-    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
-    librg_world_t *wld = (librg_world_t *)world;
-    librg_table_i64 *last_snapshot = librg_table_tbl_get(&wld->owner_map, owner_id);
+/* entity is clean, if the owner has already received its latest state */
+static uint8_t librg_entity_clean(librg_world_t *wld, librg_owner_t *owner, int64_t entity_id, librg_entity_t *entity) {
+    if (!wld->dirty_enabled || !entity) return LIBRG_FALSE;
+    int64_t *sent_epoch = librg_table_i64_get(&owner->sent_epochs, entity_id);
+    return sent_epoch && (uint64_t)*sent_epoch >= entity->dirty_epoch;
+}
 
-    /* no snapshot - means we are asking an invalid owner */
-    if (!last_snapshot) {
-        *size = 0;
-        return LIBRG_OWNER_INVALID;
+/* calls the batch handler once for all entities of the action, starting from the cursor position */
+static void librg_world_write_batch(librg_world_t *wld, int64_t owner_id, librg_owner_t *owner, uint8_t action_id, size_t iterations) {
+    librg_world *world = (librg_world *)wld;
+    librg_write_cursor_t *cursor = &owner->cursor;
+    librg_table_i64 *last_snapshot = &owner->snapshot;
+    size_t slot_size = wld->batch_slot_size[action_id];
+
+    zpl_array_clear(cursor->batch_ids);
+
+    /* same conditions as in the write loop, without the side effects */
+    for (size_t i = cursor->index; i < iterations; ++i) {
+        int64_t entity_id = LIBRG_ENTITY_INVALID;
+        int32_t condition = LIBRG_FALSE;
+
+        if (action_id == LIBRG_WRITE_CREATE) {
+            entity_id = cursor->results[i];
+            condition = librg_table_i64_get(last_snapshot, entity_id) == NULL
+                && librg_entity_foreign(world, entity_id) != LIBRG_TRUE;
+        }
+        else if (action_id == LIBRG_WRITE_UPDATE) {
+            entity_id = cursor->results[i];
+            condition = (librg_table_i64_get(last_snapshot, entity_id) != NULL
+                || librg_entity_foreign(world, entity_id) == LIBRG_TRUE)
+                && !librg_entity_clean(wld, owner, entity_id, librg_table_ent_get(&wld->entity_map, entity_id));
+        }
+        else if (action_id == LIBRG_WRITE_REMOVE) {
+            entity_id = last_snapshot->entries[i].key;
+            condition = last_snapshot->entries[i].value != LIBRG_SNAPSHOT_ALIVE
+                && librg_entity_foreign(world, entity_id) != LIBRG_TRUE;
+        }
+
+        if (condition) {
+            zpl_array_append(cursor->batch_ids, entity_id);
+        }
+    }
+
+    size_t amount = zpl_array_count(cursor->batch_ids);
+
+    /* without the memory for the payloads, all of the batched entities are rejected */
+    if (!LIBRG_ARRAY_RESERVE(cursor->batch_data, (zpl_isize)(amount * slot_size))) {
+        zpl_array_clear(cursor->batch_ids);
+        amount = 0;
     }
 
-    /* get old, and preapre new snapshot handlers */
-    librg_table_i64 next_snapshot = {0};
-    librg_table_i64_init(&next_snapshot, wld->allocator);
+    zpl_array_resize(cursor->batch_sizes, (zpl_isize)amount);
+    zpl_array_resize(cursor->batch_buffers, (zpl_isize)amount);
+    zpl_array_resize(cursor->batch_data, (zpl_isize)(amount * slot_size));
 
-    int64_t *results = (int64_t *)LIBRG_MEM_ALLOC(LIBRG_WORLDWRITE_MAXQUERY * sizeof(int64_t));
-    size_t total_amount = LIBRG_WORLDWRITE_MAXQUERY;
-    librg_world_query(world, owner_id, chunk_radius, results, &total_amount);
+    for (size_t i = 0; i < amount; ++i) {
+        cursor->batch_sizes[i] = (int32_t)slot_size;
+        cursor->batch_buffers[i] = cursor->batch_data + i * slot_size;
+    }
+
+    cursor->batch_action = action_id;
+    cursor->batch_next = 0;
+
+    if (amount == 0) {
+        return;
+    }
+
+    librg_event_batch batch = {0};
+    batch.type = action_id;
+    batch.owner_id = owner_id;
+    batch.amount = amount;
+    batch.entity_ids = cursor->batch_ids;
+    batch.buffers = cursor->batch_buffers;
+    batch.sizes = cursor->batch_sizes;
+    batch.userdata = cursor->userdata;
+
+    /* whole batch was rejected */
+    if (wld->batch_handlers[action_id](world, &batch) < 0) {
+        for (size_t i = 0; i < amount; ++i) {
+            cursor->batch_sizes[i] = LIBRG_WRITE_REJECT;
+        }
+    }
+}
+
+/* takes the payload of the entity, produced by the batch handler */
+static int32_t librg_world_write_batched(librg_write_cursor_t *cursor, librg_event_t *evt) {
+    size_t amount = zpl_array_count(cursor->batch_ids);
+
+    /* entities are visited in the same order they were batched */
+    while (cursor->batch_next < amount && cursor->batch_ids[cursor->batch_next] != evt->entity_id) {
+        cursor->batch_next++;
+    }
 
-    size_t total_written = 0;
+    if (cursor->batch_next >= amount) {
+        return LIBRG_WRITE_REJECT;
+    }
+
+    int32_t data_size = cursor->batch_sizes[cursor->batch_next];
+    char *data = cursor->batch_buffers[cursor->batch_next];
+    cursor->batch_next++;
+
+    if (data_size < 0 || (size_t)data_size > evt->size) {
+        return LIBRG_WRITE_REJECT;
+    }
+
+    zpl_memcopy(evt->buffer, data, data_size);
+    return data_size;
+}
+
+static int32_t librg_world_write_event(librg_world_t *wld, librg_write_cursor_t *cursor, librg_event_t *evt) {
+    librg_event_fn handler = wld->handlers[evt->type];
+    uint8_t batched = evt->type <= LIBRG_WRITE_REMOVE && wld->batch_handlers[evt->type] && cursor->batch_action == evt->type;
+    if (!handler && !batched) return 0;
+
+    librg_table_cache *cache = NULL;
+    int32_t data_size = 0;
+
+    /* try to reuse payload, that was already encoded for another owner during this tick */
+    if (evt->type <= LIBRG_WRITE_REMOVE && wld->cache_enabled[evt->type]) {
+        cache = &wld->cache_map[evt->type];
+        librg_cache_entry_t *entry = librg_table_cache_get(cache, evt->entity_id);
+
+        if (entry) {
+            if ((size_t)entry->size > evt->size) return LIBRG_WRITE_REJECT;
+            zpl_memcopy(evt->buffer, wld->cache_arena + entry->offset, entry->size);
+            return entry->size;
+        }
+    }
+
+    data_size = batched
+        ? librg_world_write_batched(cursor, evt)
+        : (int32_t)handler((librg_world *)wld, (librg_event*)evt);
+
+    /* if data size is bigger than the limit, we will notify user about that */
+    if (data_size > ZPL_I32_MAX) {
+        ZPL_PANIC("librg: the data size returned by the event handler is too big for the event. \
+            Ensure that you are not returning more than %d bytes.", ZPL_I32_MAX);
+    }
+
+    #ifndef LIBRG_ENABLE_EXTENDED_EVENTBUFFER
+    if (data_size > (int32_t)ZPL_U16_MAX) {
+        ZPL_PANIC("librg: the data size returned by the event handler is bigger than the event buffer size. \
+            Ensure that you are not returning more than %d bytes.", evt->size);
+    }
+    #endif
+
+    /* store the payload, rejections are not cached, since they might depend on the buffer size */
+    if (cache && data_size >= 0 && LIBRG_ARRAY_RESERVE(wld->cache_arena, zpl_array_count(wld->cache_arena) + data_size)) {
+        librg_cache_entry_t entry = { zpl_array_count(wld->cache_arena), data_size };
+        zpl_array_appendv(wld->cache_arena, evt->buffer, data_size);
+        librg_table_cache_set(cache, evt->entity_id, entry);
+    }
+
+    return data_size;
+}
+
+/**
+ * Replaces the payload with its delta against the last payload the reader has acknowledged,
+ * prefixed with the distance (in writes) to the write that carried it, or 0 if there is no such payload.
+ * Written payload is kept as a baseline of the current write, till it is acknowledged or dropped.
+ */
+static int32_t librg_world_write_delta(librg_world_t *wld, librg_owner_t *owner, librg_event_t *evt, int32_t data_size) {
+    int64_t sequence = owner->sequence + 1;
+    librg_baseline_t *baseline = librg_baseline_acked(&owner->baselines, evt->entity_id, sequence);
+
+    char header[10];
+    size_t hsize = librg_varint_write(header, baseline ? (uint64_t)(sequence - baseline->sequence) : 0);
+    if (hsize > evt->size) return LIBRG_WRITE_REJECT;
+
+    /* move raw payload aside, and encode it back into the event buffer */
+    zpl_array_clear(wld->delta_scratch);
+    if (!LIBRG_ARRAY_RESERVE(wld->delta_scratch, data_size)) return LIBRG_WRITE_REJECT;
+    zpl_array_appendv(wld->delta_scratch, evt->buffer, data_size);
+
+    zpl_memcopy(evt->buffer, header, hsize);
+    int32_t encoded = librg_delta_encode(
+        baseline ? baseline->data : NULL, baseline ? zpl_array_count(baseline->data) : 0,
+        wld->delta_scratch, data_size, evt->buffer + hsize, evt->size - hsize
+    );
+
+    /* payload is not written, unless it can be referenced later on */
+    if (encoded < 0 || !librg_baseline_store(wld, &owner->baselines, evt->entity_id, sequence, wld->delta_scratch, data_size)) {
+        return LIBRG_WRITE_REJECT;
+    }
+
+    return (int32_t)hsize + encoded;
+}
+
+static ZPL_COMPARE_PROC(librg_util_prioritycmp) {
+    const librg_priority_t *pa = (const librg_priority_t *)a;
+    const librg_priority_t *pb = (const librg_priority_t *)b;
+    if (pa->priority != pb->priority) return pa->priority < pb->priority ? 1 : -1;
+    return (pa->entity_id > pb->entity_id) - (pa->entity_id < pb->entity_id);
+}
+
+/**
+ * Accumulates priorities of the visible entities, and orders them from the most to the least important one.
+ * Priority grows on each write by the entity weight, scaled down by the distance (in chunks) to the closest owned entity,
+ * and drops to zero once the entity is written, so entities skipped due to the limited space would eventually get written.
+ */
+static void librg_world_prioritize(librg_world_t *wld, int64_t owner_id, librg_owner_t *owner, int64_t *results, size_t amount) {
+    librg_table_f32 *priorities = &owner->priorities;
+
+    /* without the memory, entities are written in the order of the query */
+    if (!LIBRG_ARRAY_RESERVE(wld->priority_order, (zpl_isize)amount)) return;
+
+    zpl_array_clear(wld->priority_origins);
+    zpl_array_clear(wld->priority_order);
+
+    for (size_t i = 0; i < amount; ++i) {
+        librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, results[i]);
+        if (!entity || entity->owner_id != owner_id || entity->chunks[0] == LIBRG_CHUNK_INVALID) continue;
+
+        librg_priority_origin_t origin = {0};
+        librg_chunk_to_chunkpos((librg_world *)wld, entity->chunks[0], &origin.x, &origin.y, &origin.z);
+        zpl_array_append(wld->priority_origins, origin);
+    }
+
+    /* accumulated priorities are marked as negative ones, the ones still marked afterwards went out of the view */
+    for (int i = 0; i < zpl_array_count(priorities->entries); ++i)
+        priorities->entries[i].value = -priorities->entries[i].value - 1.0f;
+
+    for (size_t i = 0; i < amount; ++i) {
+        librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, results[i]);
+        float *accumulated = librg_table_f32_get(priorities, results[i]);
+        float scale = 1.0f;
+
+        if (entity && entity->chunks[0] != LIBRG_CHUNK_INVALID && zpl_array_count(wld->priority_origins) > 0) {
+            int16_t x, y, z;
+            int32_t distance = ZPL_I32_MAX;
+            librg_chunk_to_chunkpos((librg_world *)wld, entity->chunks[0], &x, &y, &z);
+
+            for (int j = 0; j < zpl_array_count(wld->priority_origins); ++j) {
+                librg_priority_origin_t *origin = &wld->priority_origins[j];
+                int32_t dx = zpl_abs(x - origin->x), dy = zpl_abs(y - origin->y), dz = zpl_abs(z - origin->z);
+                distance = LIBRG_MIN(distance, LIBRG_MAX(dx, LIBRG_MAX(dy, dz)));
+            }
+
+            scale = 1.0f / (1.0f + (float)distance);
+        }
+
+        float previous = accumulated ? (*accumulated < 0 ? -*accumulated - 1.0f : *accumulated) : 0;
+        librg_priority_t item = { results[i], previous + (entity ? entity->priority_weight : 1.0f) * scale };
+
+        if (accumulated) *accumulated = item.priority;
+        else librg_table_f32_set(priorities, item.entity_id, item.priority);
+        zpl_array_append(wld->priority_order, item);
+    }
+
+    zpl_sort_array(wld->priority_order, zpl_array_count(wld->priority_order), librg_util_prioritycmp);
+
+    for (size_t i = 0; i < amount; ++i)
+        results[i] = wld->priority_order[i].entity_id;
+
+    /* entities that went out of the view are forgotten */
+    for (int i = zpl_array_count(priorities->entries) - 1; i >= 0; --i)
+        if (priorities->entries[i].value < 0) librg_table_f32_remove(priorities, priorities->entries[i].key);
+}
+
+/* results buffer of the writes finished within a single call, allocated once per world */
+static int64_t *librg_world_write_results(librg_world_t *wld) {
+    if (!wld->write_results)
+        wld->write_results = (int64_t *)zpl_alloc(wld->allocator, LIBRG_WORLDWRITE_MAXQUERY * sizeof(int64_t));
+
+    return wld->write_results;
+}
+
+/* starts a new write for the owner, abandoning any unfinished one */
+static void librg_world_write_begin_ex(librg_world_t *wld, int64_t owner_id, librg_owner_t *owner, uint8_t chunk_radius, librg_query_index_t *index, int64_t *results, void *userdata) {
+    librg_write_cursor_t *cursor = &owner->cursor;
+    librg_write_cursor_reset(owner);
+
+    /* resumable writes of different owners can be interleaved, so each owner keeps its own results */
+    if (!results && !cursor->results_buffer)
+        cursor->results_buffer = (int64_t *)zpl_alloc(wld->allocator, LIBRG_WORLDWRITE_MAXQUERY * sizeof(int64_t));
+
+    cursor->results = results ? results : cursor->results_buffer;
+    cursor->total_amount = LIBRG_WORLDWRITE_MAXQUERY;
+    librg_world_query_ex((librg_world *)wld, owner_id, chunk_radius, index, cursor->results, &cursor->total_amount);
+
+    /* most important entities are written first, otherwise sorted ids result in small deltas */
+    if (wld->priority_enabled) {
+        librg_world_prioritize(wld, owner_id, owner, cursor->results, cursor->total_amount);
+    }
+    else if (wld->wireformat == LIBRG_WIREFORMAT_COMPACT) {
+        zpl_sort_array(cursor->results, cursor->total_amount, zpl_i64_cmp(0));
+    }
+
+    /* preapre new snapshot */
+    librg_snapshot_acquire(wld, owner, &cursor->next_snapshot);
+
+    /* acknowledged snapshot outlives the write, so marks of the previous one are cleared */
+    if (wld->ack_enabled) {
+        for (int i = 0; i < zpl_array_count(owner->snapshot.entries); ++i)
+            owner->snapshot.entries[i].value = LIBRG_SNAPSHOT_KNOWN;
+    }
+
+    cursor->epoch = wld->dirty_epoch;
+
+    cursor->active = LIBRG_TRUE;
+    cursor->completed = LIBRG_FALSE;
+    cursor->action_id = LIBRG_WRITE_CREATE;
+    cursor->index = 0;
+    cursor->pending_size = -1;
+    cursor->batch_action = LIBRG_PACKAGING_TOTAL;
+    cursor->userdata = userdata;
+}
+
+/* swaps snapshot tables, once all the entities were processed */
+static void librg_world_write_finish(librg_world_t *wld, librg_owner_t *owner) {
+    librg_write_cursor_t *cursor = &owner->cursor;
+    owner->sequence++;
+
+    librg_memory_snapshot_sample(wld, &cursor->next_snapshot);
+
+    /* without acknowledgements, the write is considered delivered */
+    if (!wld->ack_enabled && wld->delta_enabled) {
+        librg_baselines_ack(&owner->baselines, owner->sequence);
+    }
+
+    if (wld->ack_enabled) {
+        /* snapshot is going to be applied only once the reader acknowledges it */
+        if (zpl_array_count(owner->unacked) >= LIBRG_WORLDWRITE_MAXUNACKED) {
+            librg_table_i64_destroy(&owner->unacked[0].snapshot);
+            zpl_array_remove_at(owner->unacked, 0);
+        }
+
+        librg_unacked_t unacked = { owner->sequence, cursor->epoch, cursor->next_snapshot };
+        zpl_array_append(owner->unacked, unacked);
+    } else {
+        librg_snapshot_release(owner, &owner->snapshot);
+        owner->snapshot = cursor->next_snapshot;
+    }
+
+    zpl_zero_item(&cursor->next_snapshot);
+
+    cursor->results = NULL;
+    cursor->active = LIBRG_FALSE;
+}
+
+/* output of the write, segments are written one after another */
+typedef struct librg_write_stream_t {
+    char *buffer;
+    size_t limit;
+    size_t written;
+} librg_write_stream_t;
+
+/**
+ * Writes entities, starting from the cursor position, till the buffer is full, or all entities are processed.
+ * In the resumable mode writing stops at the first entity that does not fit, and continues from it within the next call.
+ * Its payload is produced into a separate buffer, and kept till the next call, so the handler is called only once.
+ * Otherwise entities that do not fit are skipped, and their size is accumulated in insufficient_size.
+ * If the second stream is provided, update segments are written into it, and the rest into the first one.
+ */
+static void librg_world_write_fragment(librg_world_t *wld, int64_t owner_id, librg_owner_t *owner, librg_write_stream_t *streams, uint8_t resumable, size_t *insufficient_size) {
+    librg_world *world = (librg_world *)wld;
+    librg_write_cursor_t *cursor = &owner->cursor;
+    librg_table_i64 *last_snapshot = &owner->snapshot;
+    librg_table_i64 *next_snapshot = &cursor->next_snapshot;
+    int64_t *results = cursor->results;
+
+    uint8_t fragment_full = LIBRG_FALSE;
     librg_event_t evt = {0};
 
-    #define sz_total (total_written + sizeof(librg_segment_t))
-    #define sz_value (sz_total + value_written + sizeof(librg_segval_t))
+    /* without acknowledgements, lost or reordered unreliable updates would desync the baselines */
+    uint8_t delta = wld->delta_enabled && (wld->ack_enabled || !streams[1].buffer);
 
-    uint8_t action_id = LIBRG_WRITE_CREATE;
-    size_t buffer_limit = *size;
-    size_t insufficient_size = 0;
+    /* compact headers are variable-sized, so we reserve their upper bound, and squeeze them afterwards */
+    uint8_t compact = wld->wireformat == LIBRG_WIREFORMAT_COMPACT;
+    size_t segment_header = compact ? LIBRG_SEGMENT_COMPACT_MAX : sizeof(librg_segment_t);
+    size_t segval_header = compact ? LIBRG_SEGVAL_COMPACT_MAX : sizeof(librg_segval_t);
+
+    #define sz_total (stream->written + segment_header)
+    #define sz_value (sz_total + value_written + segval_header)
+
+    while (!cursor->completed && !fragment_full) {
+        uint8_t action_id = cursor->action_id;
+        librg_write_stream_t *stream = (action_id == LIBRG_WRITE_UPDATE && streams[1].buffer) ? &streams[1] : &streams[0];
 
-librg_lbl_ww:
+        /* even if segment does not fit, entities still need to be accounted, to keep the snapshot valid */
+        uint8_t segment_fits = sz_total < stream->limit;
+        char *segend = (stream->buffer + sz_total);
 
-    /* create and update */
-    if (sz_total < buffer_limit) {
-        librg_segment_t *seg = (librg_segment_t*)(buffer+total_written);
-        char *segend = (buffer + sz_total);
+        /* delta segments start with the sequence of the write, deltas refer to their baselines relatively to it */
+        char prefix[10];
+        size_t prefix_size = (delta && action_id == LIBRG_WRITE_UPDATE) ? librg_varint_write(prefix, (uint64_t)owner->sequence + 1) : 0;
 
         uint16_t amount = 0;
-        size_t value_written = 0;
-        size_t iterations = total_amount;
+        size_t value_written = prefix_size;
+        size_t iterations = cursor->total_amount;
+        int64_t previous_id = 0;
 
         int64_t entity_id = LIBRG_ENTITY_INVALID;
         int32_t condition = LIBRG_TRUE;
@@ -96,9 +648,16 @@ librg_lbl_ww:
             iterations = zpl_array_count(last_snapshot->entries);
         }
 
-        for (size_t i = 0; i < iterations; ++i) {
+        /* produce payloads for the whole action at once */
+        if (action_id <= LIBRG_WRITE_REMOVE && wld->batch_handlers[action_id] && cursor->batch_action != action_id) {
+            librg_world_write_batch(wld, owner_id, owner, action_id, iterations);
+        }
+
+        for (; cursor->index < iterations; ++cursor->index) {
+            size_t i = cursor->index;
             int16_t action_rejected = LIBRG_TRUE;
             int32_t data_size = 0;
+            uint8_t skipped = LIBRG_FALSE;
 
             /* preparation */
             if (action_id == LIBRG_WRITE_CREATE) {
@@ -111,13 +670,14 @@ librg_lbl_ww:
                 entity_id   = results[i];  /* it did exist */
                 entity_blob = librg_table_ent_get(&wld->entity_map, entity_id);
                 condition   = librg_table_i64_get(last_snapshot, entity_id) != NULL || librg_entity_foreign(world, entity_id) == LIBRG_TRUE;
+                skipped     = condition && librg_entity_clean(wld, owner, entity_id, entity_blob);
 
                 /* mark entity as still alive, to prevent it from being removed */
-                librg_table_i64_set(last_snapshot, entity_id, 2);
+                if (condition) librg_table_i64_set(last_snapshot, entity_id, LIBRG_SNAPSHOT_ALIVE);
             }
             else if (action_id == LIBRG_WRITE_REMOVE) {
                 entity_id   = last_snapshot->entries[i].key; /* it was not marked as updated && and not foreign */
-                condition   = last_snapshot->entries[i].value != 2
+                condition   = last_snapshot->entries[i].value != LIBRG_SNAPSHOT_ALIVE
                     && librg_entity_foreign(world, entity_id) != LIBRG_TRUE;
             }
             else if (action_id == LIBRG_WRITE_OWNER) {
@@ -125,129 +685,504 @@ librg_lbl_ww:
                 entity_blob = librg_table_ent_get(&wld->entity_map, entity_id);
                 condition   = entity_blob
                     && entity_blob->owner_id == owner_id
-                    && entity_blob->flag_owner_updated
-                    && librg_table_i64_get(&next_snapshot, entity_id);
+                    && (entity_blob->flag_owner_updated || (wld->ack_enabled && !librg_table_i64_get(last_snapshot, entity_id)))
+                    && librg_table_i64_get(next_snapshot, entity_id);
+            }
+
+            /* fragment is full, entity will be written in the next one */
+            if (resumable && condition && !skipped && (stream->written > 0 || amount > 0) && (!segment_fits || sz_value >= stream->limit)) {
+                fragment_full = LIBRG_TRUE;
+                break;
             }
 
             /* data write */
-            if (condition && sz_value < buffer_limit) {
-                librg_segval_t *val = (librg_segval_t*)(segend + value_written);
-                char *valend = (segend + value_written + sizeof(librg_segval_t));
+            if (condition && !skipped && segment_fits && sz_value < stream->limit) {
+                char *valbeg = (segend + value_written);
+                char *valend = (segend + value_written + segval_header);
 
                 /* fill in event */
                 evt.entity_id = entity_id;
                 evt.type = action_id;
-                evt.size = buffer_limit - sz_value;
+                evt.size = stream->limit - sz_value;
                 evt.buffer = valend;
                 evt.owner_id = owner_id;
-                evt.userdata = userdata;
+                evt.userdata = cursor->userdata;
+
+                /* payload is produced aside, since we do not know yet whether it is going to fit */
+                if (resumable) {
+                    evt.size = stream->limit - segment_header - prefix_size - segval_header;
+                    /* without the memory, handler gets only the space that is already there */
+                    if (!LIBRG_ARRAY_RESERVE(cursor->pending, (zpl_isize)evt.size))
+                        evt.size = (size_t)zpl_array_capacity(cursor->pending);
+                    zpl_array_resize(cursor->pending, (zpl_isize)evt.size);
+                    evt.buffer = cursor->pending;
+                }
 
-                /* call event handlers */
-                if (wld->handlers[action_id]) {
-                    data_size = (int32_t)wld->handlers[action_id](world, (librg_event*)&evt);
+                if (resumable && cursor->pending_size >= 0) {
+                    /* payload was produced during the previous call */
+                    data_size = cursor->pending_size;
+                } else {
+                    /* call event handlers */
+                    data_size = librg_world_write_event(wld, cursor, &evt);
 
-                    /* if data size is bigger than the limit, we will notify user about that */
-                    if (data_size > ZPL_I32_MAX) {
-                        ZPL_PANIC("librg: the data size returned by the event handler is too big for the event. \
-                            Ensure that you are not returning more than %d bytes.", ZPL_I32_MAX);
+                    /* replace the payload with its delta against the last one this owner has received */
+                    if (prefix_size && data_size >= 0) {
+                        data_size = librg_world_write_delta(wld, owner, &evt, data_size);
                     }
+                }
+
+                cursor->pending_size = -1;
 
-                    #ifndef LIBRG_ENABLE_EXTENDED_EVENTBUFFER
-                    if (data_size > (int32_t)ZPL_U16_MAX) {
-                        ZPL_PANIC("librg: the data size returned by the event handler is bigger than the event buffer size. \
-                            Ensure that you are not returning more than %d bytes.", evt.size);
+                if (resumable && data_size >= 0 && sz_value + data_size > stream->limit) {
+                    /* keep the payload for the next fragment */
+                    if (stream->written > 0 || amount > 0) {
+                        cursor->pending_size = data_size;
+                        fragment_full = LIBRG_TRUE;
+                        break;
                     }
-                    #endif
+
+                    /* bigger than the whole fragment */
+                    *insufficient_size += sz_value + data_size - stream->limit;
+                    data_size = LIBRG_WRITE_REJECT;
+                    if (prefix_size) librg_baseline_drop(&owner->baselines, entity_id, owner->sequence + 1);
+                }
+
+                if (resumable && data_size > 0) {
+                    zpl_memcopy(valend, cursor->pending, data_size);
                 }
 
                 /* if user returned < 0, we consider that event rejected */
                 if (data_size >= 0) {
-                    /* fill in segval */
-                    val->id = entity_id;
-                    val->size = data_size;
+                    uint16_t token = 0;
 
                     if (action_id == LIBRG_WRITE_OWNER) {
-                        val->token = entity_blob->ownership_token;
+                        token = entity_blob->ownership_token;
                     }
                     else if (action_id == LIBRG_WRITE_CREATE && entity_blob->owner_id == owner_id) {
-                        val->token = 1;
+                        token = 1;
                     }
                     else if (action_id == LIBRG_WRITE_UPDATE && entity_blob->flag_foreign) {
-                        val->token = entity_blob->ownership_token;
+                        token = entity_blob->ownership_token;
+                    }
+
+                    /* fill in segval */
+                    if (!compact) {
+                        librg_segval_t *val = (librg_segval_t*)valbeg;
+                        val->id = entity_id;
+                        val->size = data_size;
+                        val->token = token;
                     } else {
-                        val->token = 0;
+                        /* header fits into the reserved space, so the payload can be moved right behind it */
+                        size_t header = librg_segval_encode(valbeg, previous_id, entity_id, token, data_size);
+                        zpl_memmove(valbeg + header, valend, data_size);
+                        valend = valbeg + header;
+                        previous_id = entity_id;
                     }
 
                     /* increase the total size written */
-                    value_written += sizeof(librg_segval_t) + val->size;
+                    value_written += (valend - valbeg) + data_size;
                     action_rejected = LIBRG_FALSE;
                     amount++;
                 }
             }
 
             /* accumulate insufficient buffer size */
-            if (condition && sz_value >= buffer_limit) {
-                insufficient_size += (sz_value - buffer_limit);
+            if (condition && !skipped && segment_fits && sz_value >= stream->limit) {
+                *insufficient_size += (sz_value - stream->limit);
             }
 
             /* finaliztion */
             if (action_id == LIBRG_WRITE_CREATE && !action_rejected) {
                 /* mark entity as created, so it can start updating */
-                librg_table_i64_set(&next_snapshot, entity_id, 1);
+                librg_table_i64_set(next_snapshot, entity_id, wld->ack_enabled ? (LIBRG_SNAPSHOT_KNOWN | LIBRG_SNAPSHOT_WRITTEN) : LIBRG_SNAPSHOT_KNOWN);
+                librg_baseline_remove(&owner->baselines, entity_id);
+                if (wld->priority_enabled) librg_table_f32_set(&owner->priorities, entity_id, 0);
+                if (wld->dirty_enabled && !wld->ack_enabled) librg_table_i64_set(&owner->sent_epochs, entity_id, (int64_t)wld->dirty_epoch);
             }
             else if (action_id == LIBRG_WRITE_UPDATE && condition) {
                 /* consider entitry updated, without regards was it written or not */
-                librg_table_i64_set(&next_snapshot, entity_id, 1);
+                librg_table_i64_set(next_snapshot, entity_id, (wld->ack_enabled && !action_rejected) ? (LIBRG_SNAPSHOT_KNOWN | LIBRG_SNAPSHOT_WRITTEN) : LIBRG_SNAPSHOT_KNOWN);
+                if (wld->priority_enabled && !action_rejected) librg_table_f32_set(&owner->priorities, entity_id, 0);
+                if (wld->dirty_enabled && !wld->ack_enabled && !action_rejected) librg_table_i64_set(&owner->sent_epochs, entity_id, (int64_t)wld->dirty_epoch);
             }
             else if (action_id == LIBRG_WRITE_REMOVE && condition && action_rejected) {
                 /* consider entity alive, till we are able to send it */
-                librg_table_i64_set(&next_snapshot, entity_id, 1);
+                librg_table_i64_set(next_snapshot, entity_id, LIBRG_SNAPSHOT_KNOWN);
             }
-            else if (action_id == LIBRG_WRITE_OWNER && condition) {
+            else if (action_id == LIBRG_WRITE_REMOVE && condition) {
+                /* reader is going to forget about the entity, and so are we */
+                librg_baseline_remove(&owner->baselines, entity_id);
+                librg_table_i64_remove(&owner->sent_epochs, entity_id);
+            }
+            else if (action_id == LIBRG_WRITE_OWNER && condition && !action_rejected && wld->ack_enabled) {
+                /* reader is considered notified, once the write is acknowledged */
+                int64_t *state = librg_table_i64_get(next_snapshot, entity_id);
+                if (state) *state |= LIBRG_SNAPSHOT_OWNER | ((int64_t)entity_blob->ownership_token << LIBRG_SNAPSHOT_TOKEN_SHIFT);
+            }
+            else if (action_id == LIBRG_WRITE_OWNER && condition && !action_rejected) {
                 /* mark reader as notified */
                 entity_blob->flag_owner_updated = LIBRG_FALSE;
             }
         }
 
         if (amount > 0) {
-            seg->type = action_id;
-            seg->size = (uint32_t)value_written;
-            seg->amount = amount;
+            uint8_t flags = prefix_size ? LIBRG_SEGMENT_DELTA : 0;
+            if (prefix_size) zpl_memcopy(segend, prefix, prefix_size);
+            if ((action_id == LIBRG_WRITE_CREATE || action_id == LIBRG_WRITE_REMOVE) && wld->ack_enabled) flags |= LIBRG_SEGMENT_RESEND;
+
+            if (!compact) {
+                librg_segment_t *seg = (librg_segment_t*)(stream->buffer+stream->written);
+                seg->type = action_id;
+                seg->flags = flags;
+                seg->size = (uint32_t)value_written;
+                seg->amount = amount;
+
+                stream->written += sizeof(librg_segment_t) + seg->size;
+            } else {
+                size_t header = librg_segment_encode(stream->buffer+stream->written, action_id, flags, amount, (uint32_t)value_written);
+                zpl_memmove(stream->buffer+stream->written+header, segend, value_written);
 
-            total_written += sizeof(librg_segment_t) + seg->size;
+                stream->written += header + value_written;
+            }
         }
-    } else {
-        insufficient_size += sz_total - buffer_limit;
-    }
 
-    /* iterate it again till all tasks are finished */
-    switch (action_id) {
-        case LIBRG_WRITE_CREATE: action_id = LIBRG_WRITE_UPDATE; goto librg_lbl_ww;
-        case LIBRG_WRITE_UPDATE: action_id = LIBRG_WRITE_REMOVE; goto librg_lbl_ww;
-        case LIBRG_WRITE_REMOVE: action_id = LIBRG_WRITE_OWNER; goto librg_lbl_ww;
-    }
+        if (!segment_fits && !resumable) {
+            *insufficient_size += sz_total - stream->limit;
+        }
 
-    /* swap snapshot tables */
-    librg_table_i64_destroy(last_snapshot);
-    librg_table_tbl_set(&wld->owner_map, owner_id, next_snapshot);
-    LIBRG_MEM_FREE(results);
+        if (fragment_full) {
+            break;
+        }
 
-    /* write our total size */
-    *size = total_written;
+        /* iterate it again till all tasks are finished */
+        cursor->index = 0;
+
+        switch (action_id) {
+            case LIBRG_WRITE_CREATE: cursor->action_id = LIBRG_WRITE_UPDATE; break;
+            case LIBRG_WRITE_UPDATE: cursor->action_id = LIBRG_WRITE_REMOVE; break;
+            case LIBRG_WRITE_REMOVE: cursor->action_id = LIBRG_WRITE_OWNER; break;
+            default: cursor->completed = LIBRG_TRUE; break;
+        }
+    }
 
     #undef sz_total
     #undef sz_value
 
+    /* compress packed data in-place */
+    for (int i = 0; i < 2; ++i) {
+        if (wld->compression_enabled && streams[i].written > 0) {
+            streams[i].written = librg_world_compress(wld, streams[i].buffer, streams[i].written);
+        }
+    }
+}
+
+LIBRG_PRIVATE int32_t librg_world_write_ex(librg_world *world, int64_t owner_id, uint8_t chunk_radius, librg_query_index_t *index, int64_t *results, char *buffer, size_t *size, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!owner) {
+        *size = 0;
+        return LIBRG_OWNER_INVALID;
+    }
+
+    size_t insufficient_size = 0;
+    librg_write_stream_t streams[2] = {{buffer, *size, 0}, {NULL, 0, 0}};
+
+    librg_world_write_begin_ex(wld, owner_id, owner, chunk_radius, index, results, userdata);
+    librg_world_write_fragment(wld, owner_id, owner, streams, LIBRG_FALSE, &insufficient_size);
+    librg_world_write_finish(wld, owner);
+
+    *size = streams[0].written;
+
     /* if we didnt have enough space, value will be > 0 */
     return (int32_t)insufficient_size;
 }
 
+int32_t librg_world_write(librg_world *world, int64_t owner_id, uint8_t chunk_radius, char *buffer, size_t *size, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!librg_table_own_get(&wld->owner_map, owner_id)) {
+        *size = 0;
+        return LIBRG_OWNER_INVALID;
+    }
+
+    return librg_world_write_ex(world, owner_id, chunk_radius, NULL, librg_world_write_results(wld), buffer, size, userdata);
+}
+
+int32_t librg_world_write_split(librg_world *world, int64_t owner_id, uint8_t chunk_radius, char *reliable, size_t *reliable_size, char *unreliable, size_t *unreliable_size, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(reliable && reliable_size && unreliable && unreliable_size);
+    if (!reliable || !reliable_size || !unreliable || !unreliable_size) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!owner) {
+        *reliable_size = 0;
+        *unreliable_size = 0;
+        return LIBRG_OWNER_INVALID;
+    }
+
+    size_t insufficient_size = 0;
+    librg_write_stream_t streams[2] = {{reliable, *reliable_size, 0}, {unreliable, *unreliable_size, 0}};
+
+    librg_world_write_begin_ex(wld, owner_id, owner, chunk_radius, NULL, NULL, userdata);
+    librg_world_write_fragment(wld, owner_id, owner, streams, LIBRG_FALSE, &insufficient_size);
+    librg_world_write_finish(wld, owner);
+
+    *reliable_size = streams[0].written;
+    *unreliable_size = streams[1].written;
+
+    /* if we didnt have enough space, value will be > 0 */
+    return (int32_t)insufficient_size;
+}
+
+int64_t librg_world_write_sequence_get(librg_world *world, int64_t owner_id) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+    if (!owner) return LIBRG_OWNER_INVALID;
+    return owner->sequence;
+}
+
+/* applies what the reader has received within the acknowledged write */
+static void librg_world_write_acked(librg_world_t *wld, int64_t owner_id, librg_owner_t *owner, librg_unacked_t *unacked) {
+    for (int i = 0; i < zpl_array_count(unacked->snapshot.entries); ++i) {
+        int64_t entity_id = unacked->snapshot.entries[i].key;
+        int64_t state = unacked->snapshot.entries[i].value;
+
+        if (wld->dirty_enabled && (state & LIBRG_SNAPSHOT_WRITTEN)) {
+            int64_t *sent_epoch = librg_table_i64_get(&owner->sent_epochs, entity_id);
+
+            /* newer write might have been acknowledged already */
+            if (!sent_epoch || *sent_epoch < (int64_t)unacked->epoch)
+                librg_table_i64_set(&owner->sent_epochs, entity_id, (int64_t)unacked->epoch);
+        }
+
+        if (state & LIBRG_SNAPSHOT_OWNER) {
+            librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
+
+            /* ownership might have changed again since then */
+            if (entity && entity->owner_id == owner_id
+                && entity->ownership_token == (uint16_t)(state >> LIBRG_SNAPSHOT_TOKEN_SHIFT))
+                entity->flag_owner_updated = LIBRG_FALSE;
+        }
+    }
+}
+
+int8_t librg_world_write_ack(librg_world *world, int64_t owner_id, int64_t sequence) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+    if (!owner) return LIBRG_OWNER_INVALID;
+
+    for (int i = 0; i < zpl_array_count(owner->unacked); ++i) {
+        if (owner->unacked[i].sequence != sequence) continue;
+
+        /* reader now has the state of that write, older ones are not needed anymore */
+        librg_baselines_ack(&owner->baselines, sequence);
+        librg_world_write_acked(wld, owner_id, owner, &owner->unacked[i]);
+        librg_snapshot_release(owner, &owner->snapshot);
+        owner->snapshot = owner->unacked[i].snapshot;
+
+        for (int j = 0; j < i; ++j)
+            librg_table_i64_destroy(&owner->unacked[j].snapshot);
+
+        zpl_memmove(owner->unacked, owner->unacked + i + 1, (zpl_array_count(owner->unacked) - i - 1) * sizeof(librg_unacked_t));
+        zpl_array_resize(owner->unacked, zpl_array_count(owner->unacked) - i - 1);
+        return LIBRG_TRUE;
+    }
+
+    /* unknown, or already acknowledged write */
+    return LIBRG_FALSE;
+}
+
+int32_t librg_world_write_begin(librg_world *world, int64_t owner_id, uint8_t chunk_radius, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!owner) {
+        return LIBRG_OWNER_INVALID;
+    }
+
+    librg_world_write_begin_ex(wld, owner_id, owner, chunk_radius, NULL, NULL, userdata);
+    return LIBRG_OK;
+}
+
+int32_t librg_world_write_next(librg_world *world, int64_t owner_id, char *buffer, size_t *size, size_t *insufficient_size) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(size); if (!size) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!owner) {
+        *size = 0;
+        return LIBRG_OWNER_INVALID;
+    }
+
+    if (insufficient_size) *insufficient_size = 0;
+
+    /* nothing left to write */
+    if (!owner->cursor.active) {
+        *size = 0;
+        return LIBRG_FALSE;
+    }
+
+    size_t insufficient = 0;
+    librg_write_stream_t streams[2] = {{buffer, *size, 0}, {NULL, 0, 0}};
+
+    librg_world_write_fragment(wld, owner_id, owner, streams, LIBRG_TRUE, &insufficient);
+    *size = streams[0].written;
+
+    /* entities that do not fit even into an empty fragment are skipped, report how much space was missing */
+    if (insufficient_size) *insufficient_size = insufficient;
+
+    if (owner->cursor.completed) {
+        librg_world_write_finish(wld, owner);
+        return LIBRG_FALSE;
+    }
+
+    return LIBRG_TRUE;
+}
+
+int32_t librg_world_write_iovec(librg_world *world, int64_t owner_id, uint8_t chunk_radius, librg_iovec *blocks, size_t *amount, size_t *insufficient_size, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(blocks && amount); if (!blocks || !amount) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+    librg_owner_t *owner = librg_table_own_get(&wld->owner_map, owner_id);
+    if (insufficient_size) *insufficient_size = 0;
+
+    /* no snapshot - means we are asking an invalid owner */
+    if (!owner) {
+        *amount = 0;
+        return LIBRG_OWNER_INVALID;
+    }
+
+    size_t capacity = *amount;
+    size_t insufficient = 0;
+    *amount = 0;
+
+    librg_world_write_begin_ex(wld, owner_id, owner, chunk_radius, NULL, NULL, userdata);
+
+    for (size_t i = 0; i < capacity && !owner->cursor.completed; ++i) {
+        librg_iovec *block = &blocks[i];
+
+        /* take a block from the owner pool, growing it if needed */
+        if (!block->base) {
+            size_t block_size = block->len ? block->len : LIBRG_WORLDWRITE_BLOCKSIZE;
+
+            while ((size_t)zpl_array_count(owner->blocks) <= i) {
+                librg_iovec pooled = {0};
+                zpl_array_append(owner->blocks, pooled);
+            }
+
+            if (owner->blocks[i].len < block_size) {
+                zpl_free(wld->allocator, owner->blocks[i].base);
+                owner->blocks[i].base = (char *)zpl_alloc(wld->allocator, block_size);
+                owner->blocks[i].len = block_size;
+            }
+
+            block->base = owner->blocks[i].base;
+            block->len = block_size;
+        }
+
+        librg_write_stream_t streams[2] = {{block->base, block->len, 0}, {NULL, 0, 0}};
+        librg_world_write_fragment(wld, owner_id, owner, streams, LIBRG_TRUE, &insufficient);
+        block->len = streams[0].written;
+        *amount = i + 1;
+    }
+
+    /* entities that do not fit even into an empty block are skipped, report how much space was missing */
+    if (insufficient_size) *insufficient_size = insufficient;
+
+    if (owner->cursor.completed) {
+        librg_world_write_finish(wld, owner);
+        return LIBRG_FALSE;
+    }
+
+    /* remaining data can be received via librg_world_write_next */
+    return LIBRG_TRUE;
+}
+
+int32_t librg_world_write_all(librg_world *world, const int64_t *owner_ids, size_t owner_amount, uint8_t chunk_radius, char **buffers, size_t *sizes, int32_t *results, void *userdata) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(owner_ids && buffers && sizes); if (!owner_ids || !buffers || !sizes) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* single call represents a whole tick, cached payloads from the previous one are stale */
+    librg_world_tick(world);
+
+    /* build the spatial index once, and share it between all owners */
+    librg_query_index_t index = {0};
+    librg_query_index_build(wld, &index);
+
+    int64_t *entity_ids = librg_world_write_results(wld);
+    int32_t insufficient_owners = 0;
+
+    for (size_t i = 0; i < owner_amount; ++i) {
+        int32_t result = librg_world_write_ex(world, owner_ids[i], chunk_radius, &index, entity_ids, buffers[i], &sizes[i], userdata);
+        if (results) results[i] = result;
+        if (result > 0) insufficient_owners++;
+    }
+
+    librg_query_index_destroy(wld, &index);
+
+    /* amount of owners, whose buffers were not big enough */
+    return insufficient_owners;
+}
+
 // =======================================================================//
 // !
 // ! World data unpacking method
 // !
 // =======================================================================//
 
+/* delivers all collected entities of the segment to the batch handler */
+static void librg_world_read_batch(librg_world_t *wld, int64_t owner_id, uint8_t action_id, uint8_t copied, void *userdata) {
+    librg_world *world = (librg_world *)wld;
+    size_t amount = zpl_array_count(wld->read_batch_ids);
+    if (amount == 0) return;
+
+    /* copied payloads are laid out one after another */
+    if (copied) {
+        size_t offset = 0;
+        zpl_array_resize(wld->read_batch_buffers, (zpl_isize)amount);
+
+        for (size_t i = 0; i < amount; ++i) {
+            wld->read_batch_buffers[i] = wld->read_batch_data + offset;
+            offset += wld->read_batch_sizes[i];
+        }
+    }
+
+    librg_event_batch batch = {0};
+    batch.type = action_id;
+    batch.owner_id = owner_id;
+    batch.amount = amount;
+    batch.entity_ids = wld->read_batch_ids;
+    batch.buffers = wld->read_batch_buffers;
+    batch.sizes = wld->read_batch_sizes;
+    batch.userdata = userdata;
+
+    /*ignore response*/
+    wld->batch_handlers[action_id](world, &batch);
+
+    /* entities are removed only after the handler has seen them */
+    if (action_id == LIBRG_READ_REMOVE) {
+        for (size_t i = 0; i < amount; ++i) {
+            librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, wld->read_batch_ids[i]);
+            if (!entity) continue; else entity->flag_foreign = LIBRG_FALSE;
+            librg_entity_untrack(world, wld->read_batch_ids[i]);
+        }
+    }
+}
+
 int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffer, size_t size, void *userdata) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     librg_world_t *wld = (librg_world_t *)world;
@@ -255,27 +1190,69 @@ int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffe
     librg_event_t evt = {0};
     size_t total_read = 0;
 
-    #define sz_segment (total_read + sizeof(librg_segment_t))
-    #define sz_segval (sz_segment + segment_read + sizeof(librg_segval_t))
+    /* compressed buffers are restored first, no configuration is needed on the reading side */
+    if (size > 0 && (uint8_t)buffer[0] == LIBRG_COMPRESSION_FRAME) {
+        int32_t decompressed = librg_world_decompress(wld, buffer, size);
+        if (decompressed < 0) return LIBRG_READ_INVALID;
 
-    while ((size-total_read) > sizeof(librg_segment_t)) {
-        librg_segment_t *seg = (librg_segment_t*)(buffer+total_read);
+        buffer = wld->compression_scratch;
+        size = (size_t)decompressed;
+    }
+
+    #define sz_segment (total_read + segment_header)
+    #define sz_segval (sz_segment + segment_read + segval_header)
+
+    while (total_read < size) {
+        librg_segment_t _seg = {0}, *seg = &_seg;
+        librg_segval_t _val = {0}, *val = &_val;
         size_t segment_read = 0;
+        uint8_t compact = LIBRG_FALSE;
+
+        /* both wire formats can be read, each segment tells which one it is using */
+        size_t segment_header = librg_segment_decode(buffer+total_read, size-total_read, seg, &compact);
+        size_t segval_header = 0;
 
         /* immidiately exit if we will not be able to read the segment data */
-        if (sz_segment+seg->size > size || sz_segment + seg->amount * sizeof(librg_segval_t) > size) {
+        if (!segment_header || sz_segment+seg->size > size || (!compact && sz_segment + seg->amount * sizeof(librg_segval_t) > size)) {
             break;
         }
 
+        /* successfully read entities can be collected, and passed to the batch handler at once */
+        uint8_t batch_type = seg->type <= LIBRG_WRITE_REMOVE ? (uint8_t)(seg->type + LIBRG_READ_CREATE) : (uint8_t)LIBRG_PACKAGING_TOTAL;
+        uint8_t batched = batch_type < LIBRG_PACKAGING_TOTAL && wld->batch_handlers[batch_type];
+
+        /* decoded deltas are put into a shared scratch, so they need to be copied */
+        uint8_t batch_copied = batched && seg->type == LIBRG_WRITE_UPDATE && (seg->flags & LIBRG_SEGMENT_DELTA);
+
+        /* delta segments start with the sequence of the write */
+        uint64_t sequence = 0;
+        if (seg->type == LIBRG_WRITE_UPDATE && (seg->flags & LIBRG_SEGMENT_DELTA)) {
+            segment_read = librg_varint_read(buffer+sz_segment, seg->size, &sequence);
+            if (!segment_read || sequence > ZPL_I64_MAX) return LIBRG_READ_INVALID;
+        }
+
+        if (batched) {
+            zpl_array_clear(wld->read_batch_ids);
+            zpl_array_clear(wld->read_batch_sizes);
+            zpl_array_clear(wld->read_batch_buffers);
+            zpl_array_clear(wld->read_batch_data);
+        }
+
         for (int i = 0; i < seg->amount; ++i) {
-            librg_segval_t *val = (librg_segval_t*)(buffer+sz_segment+segment_read);
+            segval_header = librg_segval_decode(buffer+sz_segment+segment_read, seg->size-segment_read, compact, val);
+
+            if (!segval_header || segment_read + segval_header + val->size > seg->size) {
+                return LIBRG_READ_INVALID;
+            }
+
             librg_entity_t *entity_blob = librg_table_ent_get(&wld->entity_map, val->id);
             int8_t action_id = -1;
 
             /* do preparation for entity processing */
             if (seg->type == LIBRG_WRITE_CREATE) {
-                /* attempt to create an entity */
-                action_id = (librg_entity_track(world, val->id) == LIBRG_OK)
+                /* attempt to create an entity, repeated creation of a foreign one from an acknowledging writer is a resend */
+                action_id = (librg_entity_track(world, val->id) == LIBRG_OK
+                    || (entity_blob && entity_blob->flag_foreign && (seg->flags & LIBRG_SEGMENT_RESEND)))
                     ? LIBRG_READ_CREATE
                     : LIBRG_ERROR_CREATE;
             }
@@ -308,6 +1285,68 @@ int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffe
                 return LIBRG_READ_INVALID;
             }
 
+            /* removal repeated by an acknowledging writer, entity is already gone */
+            if (action_id == LIBRG_ERROR_REMOVE && (seg->flags & LIBRG_SEGMENT_RESEND)) {
+                segment_read += segval_header + val->size;
+                continue;
+            }
+
+            const char *payload = buffer+sz_segval;
+            size_t payload_size = val->size;
+
+            /* restore full payload from the delta, and keep it as a baseline for the next ones */
+            if (seg->type == LIBRG_WRITE_UPDATE && (seg->flags & LIBRG_SEGMENT_DELTA)) {
+                uint64_t distance = 0, decoded_size = 0;
+                size_t hsize = librg_varint_read(payload, payload_size, &distance);
+
+                if (!hsize || !librg_varint_read(payload + hsize, payload_size - hsize, &decoded_size)) {
+                    return LIBRG_READ_INVALID;
+                }
+
+                /* restored payload was written as a single segval on the other side, so it can not be any larger */
+                if (decoded_size > LIBRG_SEGVAL_MAXSIZE || distance > sequence) {
+                    return LIBRG_READ_INVALID;
+                }
+
+                librg_table_base *baselines = librg_table_bases_get(&wld->read_baselines, owner_id);
+                librg_baseline_t *baseline = (distance && baselines)
+                    ? librg_baseline_find(baselines, val->id, (int64_t)(sequence - distance))
+                    : NULL;
+
+                /* baseline was not received (or kept), payload can not be restored */
+                if (distance && !baseline) {
+                    action_id = LIBRG_ERROR_UPDATE;
+                }
+
+                /* only payloads of the valid updates are restored, and kept */
+                if (action_id == LIBRG_READ_UPDATE) {
+                    if (!baselines) {
+                        librg_table_base _baselines = {0};
+                        librg_table_bases_set(&wld->read_baselines, owner_id, _baselines);
+                        baselines = librg_table_bases_get(&wld->read_baselines, owner_id);
+                        librg_table_base_init(baselines, wld->allocator);
+                    }
+
+                    if (!LIBRG_ARRAY_RESERVE(wld->delta_scratch, (zpl_isize)decoded_size)) {
+                        return LIBRG_READ_INVALID;
+                    }
+
+                    zpl_array_resize(wld->delta_scratch, (zpl_isize)decoded_size);
+
+                    int32_t decoded = librg_delta_decode(
+                        baseline ? baseline->data : NULL, baseline ? zpl_array_count(baseline->data) : 0,
+                        payload + hsize, payload_size - hsize, wld->delta_scratch, decoded_size
+                    );
+
+                    if (decoded < 0 || !librg_baseline_store(wld, baselines, val->id, (int64_t)sequence, wld->delta_scratch, decoded)) {
+                        return LIBRG_READ_INVALID;
+                    }
+
+                    payload = wld->delta_scratch;
+                    payload_size = decoded;
+                }
+            }
+
             /* do the initial entity processing */
             if (action_id == LIBRG_READ_CREATE) {
                 /* mark newly created entity as foreign */
@@ -319,19 +1358,37 @@ int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffe
             /* fill in event */
             evt.entity_id = val->id;
             evt.type = action_id;
-            evt.size = val->size;
-            evt.buffer = (char*)(buffer+sz_segval);
+            evt.size = payload_size;
+            evt.buffer = (char*)payload;
             evt.owner_id = owner_id;
             evt.userdata = userdata;
 
             /* call event handlers */
-            if (wld->handlers[action_id]) {
+            /* payloads that could not be copied are passed to the regular handler instead */
+            if (batched && action_id == batch_type && (!batch_copied
+                || LIBRG_ARRAY_RESERVE(wld->read_batch_data, zpl_array_count(wld->read_batch_data) + (zpl_isize)payload_size))) {
+                zpl_array_append(wld->read_batch_ids, val->id);
+                zpl_array_append(wld->read_batch_sizes, (int32_t)payload_size);
+
+                if (batch_copied) {
+                    zpl_array_appendv(wld->read_batch_data, (char*)payload, (zpl_isize)payload_size);
+                } else {
+                    zpl_array_append(wld->read_batch_buffers, (char*)payload);
+                }
+            }
+            else if (wld->handlers[action_id]) {
                 /*ignore response*/
                 wld->handlers[action_id](world, &evt);
             }
 
+            /* forget the baseline of removed entities, recreated ones are looked up by the newer sequences anyway */
+            if (seg->type == LIBRG_WRITE_REMOVE) {
+                librg_table_base *baselines = librg_table_bases_get(&wld->read_baselines, owner_id);
+                if (baselines) librg_baseline_remove(baselines, val->id);
+            }
+
             /* do the afterwork processing */
-            if (action_id == LIBRG_READ_REMOVE) {
+            if (action_id == LIBRG_READ_REMOVE && !batched) {
                 /* remove foreign mark from entity */
                 librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, val->id);
                 if (!entity) return LIBRG_READ_INVALID; else entity->flag_foreign = LIBRG_FALSE;
@@ -349,7 +1406,7 @@ int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffe
                 entity->flag_foreign = LIBRG_TRUE;
             }
 
-            segment_read += sizeof(librg_segval_t) + val->size;
+            segment_read += segval_header + val->size;
         }
 
         /* validate sizes of the data we read */
@@ -357,7 +1414,11 @@ int32_t librg_world_read(librg_world *world, int64_t owner_id, const char *buffe
             return LIBRG_READ_INVALID;
         }
 
-        total_read += sizeof(librg_segment_t) + segment_read;
+        if (batched) {
+            librg_world_read_batch(wld, owner_id, batch_type, batch_copied, userdata);
+        }
+
+        total_read += segment_header + segment_read;
     }
 
     #undef sz_segment
@@ -0,0 +1,335 @@
+// file: source/persistence.c
+
+#ifdef LIBRG_EDITOR
+#include <librg.h>
+#include <zpl.h>
+#endif
+
+LIBRG_BEGIN_C_DECLS
+
+// =======================================================================//
+// !
+// ! World snapshot layout
+// !
+// =======================================================================//
+
+/* all sections are referenced by offsets from the start of the buffer, */
+/* records have a fixed size and 8-byte alignment, values use the native byte order */
+#define LIBRG_PERSIST_MAGIC   0x5747524C /* "LRGW" */
+#define LIBRG_PERSIST_VERSION 1
+
+typedef struct librg_persist_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t maxchunks;         /* value of LIBRG_ENTITY_MAXCHUNKS used by the writer */
+    uint32_t header_size;
+    uint32_t entity_size;       /* size of a single entity record */
+    uint64_t total_size;
+    uint64_t entity_count;
+    uint64_t entity_offset;
+    uint64_t override_count;
+    uint64_t override_offset;
+    uint64_t interest_count;
+    uint64_t interest_offset;
+    uint16_t worldsize[3];
+    uint16_t chunksize[3];
+    int16_t chunkoffset[3];
+    uint16_t padding;
+} librg_persist_header_t;
+
+typedef struct librg_persist_entity_t {
+    int64_t id;
+    int64_t owner_id;
+    int64_t parent_id;
+    uint64_t layers;
+    int32_t dimension;
+    float priority_weight;
+    uint16_t ownership_token;
+    uint8_t visibility_global;
+    uint8_t visibility_range;
+    uint8_t foreign;
+    uint8_t padding[3];
+    librg_chunk chunks[LIBRG_ENTITY_MAXCHUNKS];
+} librg_persist_entity_t;
+
+typedef struct librg_persist_override_t {
+    int64_t entity_id;
+    int64_t owner_id;
+    int64_t value;
+} librg_persist_override_t;
+
+typedef struct librg_persist_interest_t {
+    int64_t owner_id;
+    uint64_t layers;
+} librg_persist_interest_t;
+
+static size_t librg_persist_overrides_count(librg_entity_t *entity) {
+    if (!entity->flag_visbility_owner_enabled) return 0;
+    if (entity->owner_visibility_count != LIBRG_VISIBILITY_SPILLED) return entity->owner_visibility_count;
+    return (size_t)zpl_array_count(entity->owner_visibility.map.entries);
+}
+
+/* checks that a section fits into the buffer, without overflowing on the way */
+static int8_t librg_persist_section_valid(librg_persist_header_t *header, uint64_t offset, uint64_t count, size_t record_size) {
+    if (offset < header->header_size || offset > header->total_size) return LIBRG_FALSE;
+    return count <= (header->total_size - offset) / record_size;
+}
+
+/* checks the values that could not be restored, attachment cycles included */
+static int8_t librg_persist_records_valid(librg_world_t *wld, librg_persist_header_t *header, const char *buffer) {
+    librg_table_i64 parents = {0}, walks = {0};
+    int8_t valid = LIBRG_TRUE;
+
+    librg_table_i64_init(&parents, wld->allocator);
+    librg_table_i64_init(&walks, wld->allocator);
+    LIBRG_TABLE_RESERVE(librg_table_i64_, &parents, header->entity_count);
+    LIBRG_TABLE_RESERVE(librg_table_i64_, &walks, header->entity_count);
+
+    for (uint64_t i = 0; i < header->entity_count && valid; ++i) {
+        librg_persist_entity_t record;
+        zpl_memcopy(&record, buffer + header->entity_offset + i * sizeof(record), sizeof(record));
+        if (record.id < 0) continue;
+
+        valid = record.visibility_global <= LIBRG_VISIBLITY_ALWAYS;
+        librg_table_i64_set(&parents, record.id, record.parent_id);
+    }
+
+    for (uint64_t i = 0; i < header->override_count && valid; ++i) {
+        librg_persist_override_t item;
+        zpl_memcopy(&item, buffer + header->override_offset + i * sizeof(item), sizeof(item));
+        valid = item.value >= LIBRG_VISIBLITY_DEFAULT && item.value <= LIBRG_VISIBLITY_ALWAYS;
+    }
+
+    /* each entity is walked up till an already visited one, so every entity is visited once */
+    /* walk that comes back to one of its own entities has found a cycle */
+    for (zpl_isize i = 0; i < zpl_array_count(parents.entries) && valid; ++i) {
+        int64_t walk = (int64_t)i + 1;
+
+        for (int64_t id = (int64_t)parents.entries[i].key; id != LIBRG_ENTITY_INVALID;) {
+            int64_t *visited = librg_table_i64_get(&walks, id);
+            if (visited) { valid = *visited != walk; break; }
+
+            librg_table_i64_set(&walks, id, walk);
+            int64_t *parent_id = librg_table_i64_get(&parents, id);
+            id = parent_id ? *parent_id : LIBRG_ENTITY_INVALID;
+        }
+    }
+
+    librg_table_i64_destroy(&parents);
+    librg_table_i64_destroy(&walks);
+    return valid;
+}
+
+// =======================================================================//
+// !
+// ! Save and load
+// !
+// =======================================================================//
+
+int8_t librg_world_save(librg_world *world, char *buffer, size_t *size) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(size); if (!size) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    size_t entity_count = (size_t)zpl_array_count(wld->entity_map.entries);
+    size_t override_count = 0;
+    size_t interest_count = (size_t)zpl_array_count(wld->owner_interests.entries);
+
+    for (size_t i = 0; i < entity_count; ++i)
+        override_count += librg_persist_overrides_count(&wld->entity_map.entries[i].value);
+
+    librg_persist_header_t header = {0};
+    header.magic = LIBRG_PERSIST_MAGIC;
+    header.version = LIBRG_PERSIST_VERSION;
+    header.maxchunks = LIBRG_ENTITY_MAXCHUNKS;
+    header.header_size = sizeof(librg_persist_header_t);
+    header.entity_size = sizeof(librg_persist_entity_t);
+    header.entity_count = entity_count;
+    header.entity_offset = sizeof(librg_persist_header_t);
+    header.override_count = override_count;
+    header.override_offset = header.entity_offset + entity_count * sizeof(librg_persist_entity_t);
+    header.interest_count = interest_count;
+    header.interest_offset = header.override_offset + override_count * sizeof(librg_persist_override_t);
+    header.total_size = header.interest_offset + interest_count * sizeof(librg_persist_interest_t);
+
+    header.worldsize[0] = wld->worldsize.x; header.worldsize[1] = wld->worldsize.y; header.worldsize[2] = wld->worldsize.z;
+    header.chunksize[0] = wld->chunksize.x; header.chunksize[1] = wld->chunksize.y; header.chunksize[2] = wld->chunksize.z;
+    header.chunkoffset[0] = wld->chunkoffset.x; header.chunkoffset[1] = wld->chunkoffset.y; header.chunkoffset[2] = wld->chunkoffset.z;
+
+    /* report the required size, if the buffer is not large enough */
+    if (!buffer || *size < header.total_size) {
+        *size = (size_t)header.total_size;
+        return LIBRG_WRITE_REJECT;
+    }
+
+    zpl_memcopy(buffer, &header, sizeof(header));
+
+    char *entities = buffer + header.entity_offset;
+    char *overrides = buffer + header.override_offset;
+
+    for (size_t i = 0; i < entity_count; ++i) {
+        librg_entity_t *entity = &wld->entity_map.entries[i].value;
+        int64_t entity_id = (int64_t)wld->entity_map.entries[i].key;
+
+        librg_persist_entity_t record = {0};
+        record.id = entity_id;
+        record.owner_id = entity->owner_id;
+        record.parent_id = entity->parent_id;
+        record.layers = entity->layers;
+        record.dimension = entity->dimension;
+        record.priority_weight = entity->priority_weight;
+        record.ownership_token = entity->ownership_token;
+        record.visibility_global = entity->visibility_global;
+        record.visibility_range = entity->visibility_range;
+        record.foreign = entity->flag_foreign;
+        zpl_memcopy(record.chunks, entity->chunks, sizeof(record.chunks));
+
+        zpl_memcopy(entities, &record, sizeof(record));
+        entities += sizeof(record);
+
+        if (!entity->flag_visbility_owner_enabled) continue;
+
+        size_t amount = librg_persist_overrides_count(entity);
+        for (size_t j = 0; j < amount; ++j) {
+            librg_persist_override_t item = { entity_id, 0, 0 };
+
+            if (entity->owner_visibility_count == LIBRG_VISIBILITY_SPILLED) {
+                item.owner_id = (int64_t)entity->owner_visibility.map.entries[j].key;
+                item.value = entity->owner_visibility.map.entries[j].value;
+            } else {
+                item.owner_id = entity->owner_visibility.owners[j];
+                item.value = entity->owner_visibility_values[j];
+            }
+
+            zpl_memcopy(overrides, &item, sizeof(item));
+            overrides += sizeof(item);
+        }
+    }
+
+    for (size_t i = 0; i < interest_count; ++i) {
+        librg_persist_interest_t item = {
+            (int64_t)wld->owner_interests.entries[i].key,
+            (uint64_t)wld->owner_interests.entries[i].value,
+        };
+
+        zpl_memcopy(buffer + header.interest_offset + i * sizeof(item), &item, sizeof(item));
+    }
+
+    *size = (size_t)header.total_size;
+    return LIBRG_OK;
+}
+
+int8_t librg_world_load(librg_world *world, const char *buffer, size_t size) {
+    LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
+    LIBRG_ASSERT(buffer); if (!buffer) return LIBRG_NULL_REFERENCE;
+    librg_world_t *wld = (librg_world_t *)world;
+
+    /* snapshot can only be loaded into an empty world */
+    if (zpl_array_count(wld->entity_map.entries) > 0) {
+        return LIBRG_ENTITY_ALREADY_TRACKED;
+    }
+
+    librg_persist_header_t header = {0};
+    if (size < sizeof(header)) return LIBRG_READ_INVALID;
+    zpl_memcopy(&header, buffer, sizeof(header));
+
+    /* validate the layout, before touching the world */
+    if (header.magic != LIBRG_PERSIST_MAGIC
+     || header.version != LIBRG_PERSIST_VERSION
+     || header.maxchunks != LIBRG_ENTITY_MAXCHUNKS
+     || header.header_size != sizeof(librg_persist_header_t)
+     || header.entity_size != sizeof(librg_persist_entity_t)
+     || header.total_size > size) {
+        return LIBRG_READ_INVALID;
+    }
+
+    if (!librg_persist_section_valid(&header, header.entity_offset, header.entity_count, sizeof(librg_persist_entity_t))
+     || !librg_persist_section_valid(&header, header.override_offset, header.override_count, sizeof(librg_persist_override_t))
+     || !librg_persist_section_valid(&header, header.interest_offset, header.interest_count, sizeof(librg_persist_interest_t))) {
+        return LIBRG_READ_INVALID;
+    }
+
+    if (!librg_persist_records_valid(wld, &header, buffer)) {
+        return LIBRG_READ_INVALID;
+    }
+
+    librg_config_chunkamount_set(world, header.worldsize[0], header.worldsize[1], header.worldsize[2]);
+    librg_config_chunksize_set(world, header.chunksize[0], header.chunksize[1], header.chunksize[2]);
+    librg_config_chunkoffset_set(world, header.chunkoffset[0], header.chunkoffset[1], header.chunkoffset[2]);
+
+    /* entities are inserted into a pre-sized table, so it is never rehashed during the load */
+    LIBRG_TABLE_RESERVE(librg_table_ent_, &wld->entity_map, header.entity_count);
+
+    const char *entities = buffer + header.entity_offset;
+
+    for (uint64_t i = 0; i < header.entity_count; ++i) {
+        librg_persist_entity_t record;
+        zpl_memcopy(&record, entities + i * sizeof(record), sizeof(record));
+        if (record.id < 0) continue;
+
+        librg_entity_t entity = {0};
+        librg_entity_defaults(wld, &entity);
+
+        entity.owner_id = record.owner_id;
+        entity.parent_id = record.parent_id;
+        entity.layers = record.layers;
+        entity.dimension = record.dimension;
+        entity.priority_weight = record.priority_weight;
+        entity.ownership_token = record.ownership_token;
+        entity.visibility_global = record.visibility_global;
+        entity.visibility_range = record.visibility_range;
+        entity.flag_foreign = record.foreign ? LIBRG_TRUE : LIBRG_FALSE;
+        zpl_memcopy(entity.chunks, record.chunks, sizeof(entity.chunks));
+
+        librg_table_ent_set(&wld->entity_map, record.id, entity);
+    }
+
+    /* restore attachments and owners, once all of the entities exist */
+    for (zpl_isize i = 0; i < zpl_array_count(wld->entity_map.entries); ++i) {
+        int64_t entity_id = (int64_t)wld->entity_map.entries[i].key;
+        librg_entity_t *entity = &wld->entity_map.entries[i].value;
+
+        if (entity->parent_id != LIBRG_ENTITY_INVALID) {
+            librg_entity_t *parent = librg_table_ent_get(&wld->entity_map, entity->parent_id);
+
+            if (parent) {
+                if (!parent->children) zpl_array_init(parent->children, wld->allocator);
+                zpl_array_append(parent->children, entity_id);
+            } else {
+                entity->parent_id = LIBRG_ENTITY_INVALID;
+            }
+        }
+
+        if (entity->owner_id != LIBRG_OWNER_INVALID) {
+            librg_owner_entity_pair_t pair = { entity->owner_id, entity_id };
+            zpl_array_append(wld->owner_entity_pairs, pair);
+
+            if (!librg_table_own_get(&wld->owner_map, entity->owner_id))
+                librg_owner_create(wld, entity->owner_id);
+        }
+    }
+
+    for (uint64_t i = 0; i < header.override_count; ++i) {
+        librg_persist_override_t item;
+        zpl_memcopy(&item, buffer + header.override_offset + i * sizeof(item), sizeof(item));
+
+        librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, item.entity_id);
+        if (!entity) continue;
+
+        /* foreign entities do not matter for the overrides */
+        librg_entity_visibility_owner_set(world, item.entity_id, item.owner_id, (librg_visibility)item.value);
+    }
+
+    for (uint64_t i = 0; i < header.interest_count; ++i) {
+        librg_persist_interest_t item;
+        zpl_memcopy(&item, buffer + header.interest_offset + i * sizeof(item), sizeof(item));
+        librg_world_interest_set(world, item.owner_id, item.layers);
+    }
+
+    return LIBRG_OK;
+}
+
+#undef LIBRG_PERSIST_MAGIC
+#undef LIBRG_PERSIST_VERSION
+
+LIBRG_END_C_DECLS
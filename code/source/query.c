@@ -126,7 +126,130 @@ static LIBRG_ALWAYS_INLINE void librg_util_chunkrange(librg_world *w, librg_tabl
     return;
 }
 
-int32_t librg_world_query(librg_world *world, int64_t owner_id, uint8_t chunk_radius, int64_t *entity_ids, size_t *entity_amount) {
+/* appends attached entities right after their parent, since they share its visibility */
+static void librg_query_push_children(librg_world_t *wld, int64_t owner_id, librg_entity_t *entity, int64_t *entity_ids, size_t buffer_limit, size_t *result_amount) {
+    for (zpl_isize i = 0; entity->children && i < zpl_array_count(entity->children); ++i) {
+        librg_entity_t *child = librg_table_ent_get(&wld->entity_map, entity->children[i]);
+        if (!child) continue;
+
+        /* owned children (with their own children) are pushed by the owner itself */
+        if (child->owner_id == owner_id) continue;
+
+        if (*result_amount + 1 <= buffer_limit) entity_ids[*result_amount] = entity->children[i];
+        (*result_amount)++;
+
+        librg_query_push_children(wld, owner_id, child, entity_ids, buffer_limit, result_amount);
+    }
+}
+
+/* checks if any of the owned entities is within the visibility range of the entity */
+static int8_t librg_query_in_range(librg_world_t *wld, librg_entity_t *entity) {
+    int32_t range2 = entity->visibility_range * entity->visibility_range;
+
+    for (int k = 0; k < LIBRG_ENTITY_MAXCHUNKS; ++k) {
+        if (entity->chunks[k] == LIBRG_CHUNK_INVALID) break;
+
+        int16_t chx=0, chy=0, chz=0;
+        librg_chunk_to_chunkpos((librg_world *)wld, entity->chunks[k], &chx, &chy, &chz);
+
+        for (zpl_isize i = 0; i < zpl_array_count(wld->query_origins); ++i) {
+            librg_query_origin_t *origin = &wld->query_origins[i];
+            if (origin->dimension != entity->dimension) continue;
+
+            int32_t x = origin->x - chx, y = origin->y - chy, z = origin->z - chz;
+            if (x*x+y*y+z*z <= range2) return LIBRG_TRUE;
+        }
+    }
+
+    return LIBRG_FALSE;
+}
+
+LIBRG_PRIVATE void librg_query_index_build(librg_world_t *wld, librg_query_index_t *index) {
+    size_t total_count = zpl_array_count(wld->entity_map.entries);
+
+    librg_table_tbl_init(&index->chunks, wld->allocator);
+    zpl_array_init_reserve(index->nodes, wld->allocator, total_count + 1);
+    zpl_array_init(index->special, wld->allocator);
+    zpl_array_init_reserve(index->candidates, wld->allocator, total_count + 1);
+    zpl_array_init_reserve(index->stamps, wld->allocator, total_count + 1);
+    zpl_array_init_reserve(index->pairs, wld->allocator, zpl_array_count(wld->owner_entity_pairs) + 1);
+    librg_table_i64_init(&index->owners, wld->allocator);
+    index->stamp = 0;
+
+    zpl_array_resize(index->stamps, (zpl_isize)total_count);
+    zpl_memset(index->stamps, 0, sizeof(uint32_t) * total_count);
+
+    /* group owner-entity pairs by owner, keeping their order, so each owner query can skip the foreign ones */
+    size_t pair_count = zpl_array_count(wld->owner_entity_pairs);
+    zpl_array_resize(index->pairs, (zpl_isize)pair_count);
+
+    for (size_t i = 0; i < pair_count; ++i) {
+        int64_t *amount = librg_table_i64_get(&index->owners, wld->owner_entity_pairs[i].owner_id);
+        librg_table_i64_set(&index->owners, wld->owner_entity_pairs[i].owner_id, amount ? *amount + 1 : 1);
+    }
+
+    for (int64_t i = 0, offset = 0; i < zpl_array_count(index->owners.entries); ++i) {
+        int64_t amount = index->owners.entries[i].value;
+        index->owners.entries[i].value = offset;
+        offset += amount;
+    }
+
+    for (size_t i = 0; i < pair_count; ++i) {
+        int64_t *offset = librg_table_i64_get(&index->owners, wld->owner_entity_pairs[i].owner_id);
+        index->pairs[(*offset)++] = wld->owner_entity_pairs[i];
+    }
+
+    for (size_t i = 0; i < total_count; ++i) {
+        librg_entity_t *entity = &wld->entity_map.entries[i].value;
+
+        /* attached entities are never tested on their own */
+        if (entity->parent_id != LIBRG_ENTITY_INVALID) continue;
+
+        /* entities with overrides are checked for each owner, even outside of the visible chunks */
+        if (entity->flag_visbility_owner_enabled || entity->visibility_global == LIBRG_VISIBLITY_ALWAYS || entity->visibility_range > 0) {
+            zpl_array_append(index->special, (int64_t)i);
+        }
+        else if (entity->visibility_global == LIBRG_VISIBLITY_NEVER) continue;
+
+        if (entity->chunks[0] == LIBRG_CHUNK_INVALID) continue;
+
+        librg_table_i64 *dim_chunks = librg_table_tbl_get(&index->chunks, entity->dimension);
+
+        if (!dim_chunks) {
+            librg_table_i64 _chunks = {0};
+            librg_table_tbl_set(&index->chunks, entity->dimension, _chunks);
+            dim_chunks = librg_table_tbl_get(&index->chunks, entity->dimension);
+            librg_table_i64_init(dim_chunks, wld->allocator);
+        }
+
+        for (int k = 0; k < LIBRG_ENTITY_MAXCHUNKS; ++k) {
+            if (entity->chunks[k] == LIBRG_CHUNK_INVALID) break;
+
+            int64_t *head = librg_table_i64_get(dim_chunks, entity->chunks[k]);
+            librg_query_node_t node = { (int64_t)i, head ? *head : -1 };
+
+            librg_table_i64_set(dim_chunks, entity->chunks[k], zpl_array_count(index->nodes));
+            zpl_array_append(index->nodes, node);
+        }
+    }
+}
+
+LIBRG_PRIVATE void librg_query_index_destroy(librg_world_t *wld, librg_query_index_t *index) {
+    zpl_unused(wld);
+
+    for (int i = 0; i < zpl_array_count(index->chunks.entries); ++i)
+        librg_table_i64_destroy(&index->chunks.entries[i].value);
+
+    librg_table_tbl_destroy(&index->chunks);
+    librg_table_i64_destroy(&index->owners);
+    zpl_array_free(index->nodes);
+    zpl_array_free(index->special);
+    zpl_array_free(index->candidates);
+    zpl_array_free(index->stamps);
+    zpl_array_free(index->pairs);
+}
+
+LIBRG_PRIVATE int32_t librg_world_query_ex(librg_world *world, int64_t owner_id, uint8_t chunk_radius, librg_query_index_t *index, int64_t *entity_ids, size_t *entity_amount) {
     LIBRG_ASSERT(world); if (!world) return LIBRG_WORLD_INVALID;
     LIBRG_ASSERT(entity_amount); if (!entity_amount) return LIBRG_NULL_REFERENCE;
     librg_world_t *wld = (librg_world_t *)world;
@@ -135,23 +258,43 @@ int32_t librg_world_query(librg_world *world, int64_t owner_id, uint8_t chunk_ra
     size_t total_count = zpl_array_count(wld->entity_map.entries);
     size_t result_amount = 0;
 
+    librg_owner_entity_pair_t *pairs = wld->owner_entity_pairs;
+    size_t pair_amount = zpl_array_count(wld->owner_entity_pairs);
+    zpl_array_clear(wld->query_origins);
+
+    /* visibility layers the owner is interested in */
+    int64_t *interest_value = librg_table_i64_get(&wld->owner_interests, owner_id);
+    uint64_t interest = interest_value ? (uint64_t)*interest_value : LIBRG_LAYERS_ALL;
+
     /* mini helper for pushing entity */
     /* if it will overflow do not push, just increase counter for future statistics */
-    #define librg_push_entity(entity_id) \
-        { if (result_amount + 1 <= buffer_limit) entity_ids[result_amount++] = entity_id; else result_amount++; }
+    #define librg_push_entity(entity_id, entity) \
+        { if (result_amount + 1 <= buffer_limit) entity_ids[result_amount++] = entity_id; else result_amount++; \
+          if (entity->children) librg_query_push_children(wld, owner_id, entity, entity_ids, buffer_limit, &result_amount); }
+
+    /* with a shared index, only look at the range of pairs belonging to this owner */
+    if (index) {
+        int64_t *end = librg_table_i64_get(&index->owners, owner_id);
+        pair_amount = 0;
+
+        while (end && pair_amount < (size_t)*end && index->pairs[*end - 1 - pair_amount].owner_id == owner_id)
+            pair_amount++;
+
+        pairs = index->pairs + (end ? *end : 0) - pair_amount;
+    }
 
     /* generate a map of visible chunks (only counting owned entities) */
-    for (int i = 0; i < zpl_array_count(wld->owner_entity_pairs); ++i) {
-        if (wld->owner_entity_pairs[i].owner_id != owner_id) continue;
+    for (size_t i = 0; i < pair_amount; ++i) {
+        if (pairs[i].owner_id != owner_id) continue;
 
-        uint64_t entity_id = wld->owner_entity_pairs[i].entity_id;
+        uint64_t entity_id = pairs[i].entity_id;
         librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, entity_id);
 
         /* allways add self-owned entities */
-        int8_t vis_owner = librg_entity_visibility_owner_get(world, entity_id, owner_id);
+        int8_t vis_owner = librg_visibility_owner_find(entity, owner_id);
         if (vis_owner != LIBRG_VISIBLITY_NEVER) {
             /* prevent from being included */
-            librg_push_entity(entity_id);
+            librg_push_entity(entity_id, entity);
         }
 
         /* immidiately skip, if entity was not placed correctly */
@@ -176,62 +319,108 @@ int32_t librg_world_query(librg_world *world, int64_t owner_id, uint8_t chunk_ra
             int16_t chx=0, chy=0, chz=0;
             librg_chunk_to_chunkpos(world, entity->chunks[k], &chx, &chy, &chz);
             librg_util_chunkrange(world, dim_chunks, chx, chy, chz, chunk_radius);
+
+            librg_query_origin_t origin = { entity->dimension, chx, chy, chz };
+            zpl_array_append(wld->query_origins, origin);
         }
     }
 
+    /* with a shared index, mark entities located in the visible chunks, and check only those and the special ones */
+    uint32_t stamp = 0;
+
+    if (index) {
+        stamp = ++index->stamp;
+        zpl_array_clear(index->candidates);
+
+        for (int d = 0; d < zpl_array_count(wld->dimensions.entries); ++d) {
+            librg_table_i64 *visible = &wld->dimensions.entries[d].value;
+            librg_table_i64 *dim_chunks = librg_table_tbl_get(&index->chunks, wld->dimensions.entries[d].key);
+            if (!dim_chunks) continue;
+
+            for (int k = 0; k < zpl_array_count(visible->entries); ++k) {
+                int64_t *head = librg_table_i64_get(dim_chunks, visible->entries[k].key);
+
+                for (int64_t n = head ? *head : -1; n != -1; n = index->nodes[n].next) {
+                    int64_t i = index->nodes[n].entity_index;
+                    if (index->stamps[i] == stamp) continue;
+
+                    index->stamps[i] = stamp;
+                    zpl_array_append(index->candidates, i);
+                }
+            }
+        }
+
+        for (zpl_isize n = 0; n < zpl_array_count(index->special); ++n) {
+            if (index->stamps[index->special[n]] != stamp) zpl_array_append(index->candidates, index->special[n]);
+        }
+
+        /* results are in the same order as without the index */
+        zpl_sort_array(index->candidates, zpl_array_count(index->candidates), zpl_i64_cmp(0));
+    }
+
+    size_t iterations = index ? (size_t)zpl_array_count(index->candidates) : total_count;
+
     /* iterate on all entities, and check if they are inside of the interested chunks */
-    for (size_t i=0; i < total_count; ++i) {
+    for (size_t n=0; n < iterations; ++n) {
+        size_t i = index ? (size_t)index->candidates[n] : n;
         uint64_t entity_id = wld->entity_map.entries[i].key;
         librg_entity_t *entity = &wld->entity_map.entries[i].value;
         librg_table_i64 *chunks = librg_table_tbl_get(&wld->dimensions, entity->dimension);
 
         if (entity->owner_id == owner_id) continue;
+        if (entity->parent_id != LIBRG_ENTITY_INVALID) continue;
 
         /* owner visibility (personal)*/
-        int8_t vis_owner = librg_entity_visibility_owner_get(world, entity_id, owner_id);
+        int8_t vis_owner = librg_visibility_owner_find(entity, owner_id);
         if (vis_owner == LIBRG_VISIBLITY_NEVER) {
             continue; /* prevent from being included */
         }
         else if (vis_owner == LIBRG_VISIBLITY_ALWAYS) {
-            librg_push_entity(entity_id);
+            librg_push_entity(entity_id, entity);
             continue;
         }
 
+        /* entity is not on any of the layers the owner is interested in */
+        if (!(entity->layers & interest)) continue;
+
         /* global entity visibility */
-        int8_t vis_global = librg_entity_visibility_global_get(world, entity_id);
+        int8_t vis_global = entity->visibility_global;
         if (vis_global == LIBRG_VISIBLITY_NEVER) {
             continue; /* prevent from being included */
         }
         else if (vis_global == LIBRG_VISIBLITY_ALWAYS) {
-            librg_push_entity(entity_id);
+            librg_push_entity(entity_id, entity);
             continue;
         }
 
         /* skip if there are no chunks in this dimension */
         if (!chunks) continue;
-        size_t chunk_amount = zpl_array_count(chunks->entries);
+        int8_t visible = index ? index->stamps[i] == stamp : LIBRG_FALSE;
 
-        for (size_t k = 0; k < chunk_amount; ++k) {
+        for (size_t k = 0; !index && !visible && k < (size_t)zpl_array_count(chunks->entries); ++k) {
             librg_chunk chunk = chunks->entries[k].key;
 
             for (size_t j=0; j < LIBRG_ENTITY_MAXCHUNKS; ++j) {
                 /* immidiately exit if chunk is invalid (the rest will also be invalid) */
                 if (entity->chunks[j] == LIBRG_CHUNK_INVALID) break;
 
-                /* add entity and continue to the next one */
+                /* entity spanning several visible chunks is still added only once */
                 if (entity->chunks[j] == chunk) {
-                    librg_push_entity(entity_id);
+                    visible = LIBRG_TRUE;
                     break;
                 }
             }
         }
+
+        /* entity can be seen from further away, than the observer radius reaches */
+        if (visible || (entity->visibility_range > chunk_radius && librg_query_in_range(wld, entity))) {
+            librg_push_entity(entity_id, entity);
+        }
     }
 
-    /* free up temp data */
+    /* clear temp data, chunk sets are kept allocated for the next query */
     for (int i = 0; i < zpl_array_count(wld->dimensions.entries); ++i)
-        librg_table_i64_destroy(&wld->dimensions.entries[i].value);
-
-    librg_table_tbl_clear(&wld->dimensions);
+        librg_table_i64_clear(&wld->dimensions.entries[i].value);
 
     #undef librg_push_entity
 
@@ -239,4 +428,8 @@ int32_t librg_world_query(librg_world *world, int64_t owner_id, uint8_t chunk_ra
     return LIBRG_MAX(0, (int32_t)(result_amount - buffer_limit));
 }
 
+int32_t librg_world_query(librg_world *world, int64_t owner_id, uint8_t chunk_radius, int64_t *entity_ids, size_t *entity_amount) {
+    return librg_world_query_ex(world, owner_id, chunk_radius, NULL, entity_ids, entity_amount);
+}
+
 LIBRG_END_C_DECLS
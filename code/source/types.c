@@ -53,12 +53,42 @@ LIBRG_BEGIN_C_DECLS
 #define LIBRG_ENTITY_MAXCHUNKS 8
 #endif
 
+/* defines how many per-owner visibility overrides */
+/* are stored inline, before moving them into a hash table */
+#ifndef LIBRG_ENTITY_VISIBILITY_INLINE
+#define LIBRG_ENTITY_VISIBILITY_INLINE 4
+#endif
+
 /* defines how many max entity ids could be used  */
 /* inside of the librg_world_write call */
 #ifndef LIBRG_WORLDWRITE_MAXQUERY
 #define LIBRG_WORLDWRITE_MAXQUERY 16384
 #endif
 
+/* defines the size of blocks allocated by librg */
+/* inside of the librg_world_write_iovec call */
+#ifndef LIBRG_WORLDWRITE_BLOCKSIZE
+#define LIBRG_WORLDWRITE_BLOCKSIZE 1200
+#endif
+
+/* defines the largest buffer that is compressed by the writer, */
+/* and accepted for decompression by the reader */
+#ifndef LIBRG_COMPRESSION_MAXSIZE
+#define LIBRG_COMPRESSION_MAXSIZE (1 << 20)
+#endif
+
+/* defines how many writes can wait for an acknowledgement */
+/* before the oldest one is dropped */
+#ifndef LIBRG_WORLDWRITE_MAXUNACKED
+#define LIBRG_WORLDWRITE_MAXUNACKED 64
+#endif
+
+/* defines how many writes old a delta encoding baseline can be */
+/* older ones are dropped, and the payload is sent in full instead */
+#ifndef LIBRG_WORLDWRITE_MAXBASELINES
+#define LIBRG_WORLDWRITE_MAXBASELINES 16
+#endif
+
 /* validate that value is less than maximum allowed */
 #if LIBRG_WORLDWRITE_MAXQUERY > ZPL_U16_MAX
 #error "LIBRG_WORLDWRITE_MAXQUERY must have value less than 65535"
@@ -79,7 +109,27 @@ LIBRG_BEGIN_C_DECLS
 
 ZPL_TABLE(static inline, librg_table_i8, librg_table_i8_, int8_t);
 ZPL_TABLE(static inline, librg_table_i64, librg_table_i64_, int64_t);
+ZPL_TABLE(static inline, librg_table_f32, librg_table_f32_, float);
 ZPL_TABLE(static inline, librg_table_tbl, librg_table_tbl_, librg_table_i64);
+/* update payload of an entity, as it was carried by the write with the given sequence */
+typedef struct librg_baseline_t {
+    int64_t sequence;           /* or -1, if the slot is free */
+    uint8_t acked;              /* writer only, the write was acknowledged by the reader */
+    zpl_array(char) data;
+} librg_baseline_t;
+
+ZPL_TABLE(static inline, librg_table_base, librg_table_base_, zpl_array(librg_baseline_t));
+ZPL_TABLE(static inline, librg_table_bases, librg_table_bases_, librg_table_base);
+
+/* pre-sizes hashes and entries of a table, so it would not be rehashed until it holds that many items */
+#define LIBRG_TABLE_RESERVE(FUNC, h, amount) do {                                   \
+    zpl_isize _hashes = (zpl_isize)((amount) / 0.75f) + 1;                          \
+    if (zpl_array_count((h)->hashes) < _hashes) ZPL_JOIN2(FUNC, rehash)(h, _hashes); \
+    zpl_array_reserve((h)->entries, (zpl_isize)(amount));                           \
+} while (0)
+
+/* owner visibility overrides did not fit inline, and were moved into the hash table */
+#define LIBRG_VISIBILITY_SPILLED 0xFF
 
 enum  {
     LIBRG_WRITE_OWNER = (LIBRG_ERROR_REMOVE+1),
@@ -94,21 +144,92 @@ typedef struct librg_entity_t {
     uint8_t flag_owner_updated : 1;
     uint8_t flag_foreign : 1;
     uint8_t flag_visbility_owner_enabled : 1;
-    uint8_t flag_unused2 : 1;
+    uint8_t flag_coverage_cached : 1;   /* coverage box matches the chunks */
 
     uint16_t ownership_token;
 
     int32_t dimension;
     int64_t owner_id;
+    int64_t parent_id;          /* entity this one is attached to, or LIBRG_ENTITY_INVALID */
+    zpl_array(int64_t) children; /* entities attached to this one, allocated on the first attachment */
+    float priority_weight;
+    int8_t owner_visibility_values[LIBRG_ENTITY_VISIBILITY_INLINE]; /* kept apart from the owners, to fill the padding */
+    uint64_t layers;            /* visibility layers, entity is visible only to owners interested in any of them */
+    uint64_t dirty_epoch;       /* epoch of the last change of the entity */
+    uint32_t slot;              /* index of the handle slot + 1, or 0 if no handle was requested */
+    uint8_t visibility_range;   /* chunk radius, from which the entity can be seen regardless of the observer radius */
+    uint8_t owner_visibility_count; /* amount of inline overrides, or LIBRG_VISIBILITY_SPILLED */
 
     librg_chunk chunks[LIBRG_ENTITY_MAXCHUNKS];
-    librg_table_i8 owner_visibility_map;
+    int32_t coverage[6];        /* chunk grid box set via librg_entity_aabb_set */
+    union {
+        int64_t owners[LIBRG_ENTITY_VISIBILITY_INLINE];
+        librg_table_i8 map;
+    } owner_visibility;
 
     void *userdata;
 } librg_entity_t;
 
 ZPL_TABLE(static inline, librg_table_ent, librg_table_ent_, librg_entity_t);
 
+/* dense slot, that maps an entity handle onto the entity storage */
+typedef struct librg_entity_slot_t {
+    uint32_t generation;        /* incremented each time the slot is released */
+    int32_t index;              /* index within the entity storage, or -1 if the slot is free */
+} librg_entity_slot_t;
+
+/* state of the write, that can be continued over multiple fragments */
+typedef struct librg_write_cursor_t {
+    uint8_t active;             /* write was started and not yet finished */
+    uint8_t completed;          /* all entities were processed */
+    uint8_t action_id;          /* currently processed action */
+    size_t index;               /* index of the next entity within the current action */
+    int64_t *results;           /* entities visible to the owner */
+    int64_t *results_buffer;    /* results of the resumable writes, kept till the owner is destroyed */
+    size_t total_amount;
+    librg_table_i64 next_snapshot;
+    uint64_t epoch;             /* dirty tracking epoch at the start of the write */
+    int32_t pending_size;       /* size of the payload that did not fit into the previous fragment, or -1 */
+    zpl_array(char) pending;
+    void *userdata;
+
+    /* payloads produced by the batch handler for the current action */
+    uint8_t batch_action;       /* action the batch was produced for, or LIBRG_PACKAGING_TOTAL */
+    size_t batch_next;          /* index of the next entity within the batch */
+    zpl_array(int64_t) batch_ids;
+    zpl_array(int32_t) batch_sizes;
+    zpl_array(char *) batch_buffers;
+    zpl_array(char) batch_data;
+} librg_write_cursor_t;
+
+/* snapshot of a write, that was not yet acknowledged by the reader */
+typedef struct librg_unacked_t {
+    int64_t sequence;
+    uint64_t epoch;             /* entities written within the write are sent as of this epoch */
+    librg_table_i64 snapshot;
+} librg_unacked_t;
+
+typedef struct librg_owner_t {
+    librg_table_i64 snapshot;   /* entity -> state of the entity, as it is known to the owner */
+    librg_table_i64 spare;      /* cleared snapshot, reused for the next write instead of allocating a new one */
+    librg_table_base baselines; /* entity -> written update payloads, the acknowledged one is used for delta encoding */
+    librg_table_f32 priorities; /* entity -> accumulated priority, since the entity was last written */
+    librg_table_i64 sent_epochs; /* entity -> world epoch, at which the entity was last written */
+    librg_write_cursor_t cursor;
+    zpl_array(librg_iovec) blocks; /* pooled blocks, reused between iovec writes */
+    int64_t sequence;           /* sequence number of the last write */
+    zpl_array(librg_unacked_t) unacked;
+} librg_owner_t;
+
+ZPL_TABLE(static inline, librg_table_own, librg_table_own_, librg_owner_t);
+
+typedef struct librg_cache_entry_t {
+    int64_t     offset;         /* offset of the cached payload within the cache arena */
+    int32_t     size;           /* size of the cached payload */
+} librg_cache_entry_t;
+
+ZPL_TABLE(static inline, librg_table_cache, librg_table_cache_, librg_cache_entry_t);
+
 typedef struct librg_event_t {
     uint8_t     type;           /* type of the event that was called, might be useful in bindings */
     int64_t     owner_id;       /* id of the owner who this event is called for */
@@ -123,9 +244,27 @@ typedef struct librg_owner_entity_pair_t {
     int64_t     entity_id;      /* id of an entity which this event is called about */
 } librg_owner_entity_pair_t;
 
+/* accumulated priority of a visible entity */
+typedef struct librg_priority_t {
+    int64_t     entity_id;
+    float       priority;
+} librg_priority_t;
+
+/* chunk position of an owned entity, used to scale down the priorities of the distant ones */
+typedef struct librg_priority_origin_t {
+    int16_t     x, y, z;
+} librg_priority_origin_t;
+
+/* chunk position of an owned entity, used as an origin for the per-entity visibility range */
+typedef struct librg_query_origin_t {
+    int32_t     dimension;
+    int16_t     x, y, z;
+} librg_query_origin_t;
+
 typedef struct librg_world_t {
     uint8_t valid;
     zpl_allocator allocator;
+    librg_allocator allocator_callbacks; /* used by the allocator, if the world was created with a custom one */
     zpl_random random;
 
     struct { uint16_t x, y, z; } worldsize;
@@ -133,16 +272,89 @@ typedef struct librg_world_t {
     struct { int16_t x, y, z; } chunkoffset;
 
     librg_event_fn handlers[LIBRG_PACKAGING_TOTAL];
+    librg_event_batch_fn batch_handlers[LIBRG_PACKAGING_TOTAL];
+    size_t batch_slot_size[LIBRG_PACKAGING_TOTAL];
     librg_table_ent entity_map;
-    librg_table_tbl owner_map;
+    librg_table_own owner_map;
 
     librg_table_tbl dimensions;
+    zpl_array(librg_query_origin_t) query_origins;
+    librg_table_i64 owner_interests; /* owner -> mask of visibility layers, all layers if missing */
 
     /* owner-entity pair, needed for more effective query */
     /* achieved by caching only owned entities and reducing the first iteration cycle */
     zpl_array(librg_owner_entity_pair_t) owner_entity_pairs;
 
+    /* handle slots of the entities, and a list of released ones */
+    zpl_array(librg_entity_slot_t) entity_slots;
+    zpl_array(uint32_t) entity_slots_free;
+
+    /* capacity that every owner table gets on creation, see librg_world_reserve */
+    size_t reserve_per_owner;
+
+    /* encode-once cache of the write event payloads, shared between owners within a tick */
+    uint8_t cache_enabled[LIBRG_WRITE_REMOVE+1];
+    librg_table_cache cache_map[LIBRG_WRITE_REMOVE+1];
+    zpl_array(char) cache_arena;
+
+    /* delta encoding of the update payloads against per-owner baselines */
+    uint8_t delta_enabled;
+    librg_table_bases read_baselines; /* owner -> entity -> recently read update payloads */
+    zpl_array(char) delta_scratch;
+
+    /* entities of the currently read segment, delivered to the batch handler at once */
+    zpl_array(int64_t) read_batch_ids;
+    zpl_array(int32_t) read_batch_sizes;
+    zpl_array(char *) read_batch_buffers;
+    zpl_array(char) read_batch_data;
+
+    /* ordering of the written entities by accumulated priority */
+    uint8_t priority_enabled;
+    zpl_array(librg_priority_origin_t) priority_origins;
+    zpl_array(librg_priority_t) priority_order;
+
+    /* query results of the writes that are finished within a single call */
+    int64_t *write_results;
+
+    /* skipping of updates for entities, that have not changed since they were last written */
+    uint8_t dirty_enabled;
+    uint64_t dirty_epoch;
+
+    /* snapshots are applied only once acknowledged by the reader */
+    uint8_t ack_enabled;
+
+    /* format of the segment and segval headers used for writing */
+    uint8_t wireformat;
+
+    /* optional compression stage of the written buffers */
+    uint8_t compression_enabled;
+    librg_codec_fn compression_encode;
+    librg_codec_fn compression_decode;
+    zpl_array(char) compression_dictionary;
+    zpl_array(char) compression_scratch;
+    librg_compression_stats compression_stats;
+
+    /* maximum values sampled by librg_world_memory_stats */
+    librg_memory_stats memory_sampled;
+
     void *userdata;
 } librg_world_t;
 
+typedef struct librg_query_node_t {
+    int64_t     entity_index;   /* index of the entity within the entity_map entries */
+    int64_t     next;           /* index of the next node within the same chunk, or -1 */
+} librg_query_node_t;
+
+/* shared per-tick interest index, used to compute queries for many owners at once */
+typedef struct librg_query_index_t {
+    librg_table_tbl chunks;     /* dimension -> (chunk -> first node) */
+    zpl_array(librg_query_node_t) nodes;
+    zpl_array(int64_t) special; /* entities with visibility overrides, checked one by one */
+    zpl_array(int64_t) candidates; /* entities to check for the current owner, in storage order */
+    zpl_array(librg_owner_entity_pair_t) pairs; /* owner-entity pairs, grouped by owner */
+    librg_table_i64 owners;     /* owner -> end of its range within pairs */
+    zpl_array(uint32_t) stamps; /* per-entity marker, used to deduplicate results */
+    uint32_t stamp;
+} librg_query_index_t;
+
 LIBRG_END_C_DECLS
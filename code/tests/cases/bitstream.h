@@ -0,0 +1,145 @@
+static float bitstream_position[3] = {0};
+
+int32_t bitstream_position_write(librg_world *world, librg_event *event) {
+    librg_bitstream stream = {0};
+    librg_bitstream_from_event(world, event, &stream);
+
+    for (int i = 0; i < 3; ++i) {
+        if (librg_bitstream_write_float(&stream, bitstream_position[i], -1024.0f, 1024.0f, 0.01f) != LIBRG_OK) {
+            return LIBRG_WRITE_REJECT;
+        }
+    }
+
+    return (int32_t)librg_bitstream_size(&stream);
+}
+
+int32_t bitstream_position_read(librg_world *world, librg_event *event) {
+    librg_bitstream stream = {0};
+    librg_bitstream_from_event(world, event, &stream);
+
+    for (int i = 0; i < 3; ++i) {
+        librg_bitstream_read_float(&stream, &bitstream_position[i], -1024.0f, 1024.0f, 0.01f);
+    }
+
+    return 0;
+}
+
+MODULE(bitstream, {
+    int8_t r = -1;
+
+    IT("should write and read raw bits", {
+        char buffer[16] = {0};
+        librg_bitstream stream = {0};
+        uint64_t value = 0;
+
+        r = librg_bitstream_init(&stream, buffer, 2); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_write_bits(&stream, 5, 3); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_write_bits(&stream, 1023, 10); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_bitstream_size(&stream), 2);
+        r = librg_bitstream_write_bits(&stream, 15, 4); EQUALS(r, LIBRG_WRITE_REJECT);
+
+        r = librg_bitstream_init(&stream, buffer, 2); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_read_bits(&stream, &value, 3); EQUALS(r, LIBRG_OK); EQUALS(value, 5);
+        r = librg_bitstream_read_bits(&stream, &value, 10); EQUALS(r, LIBRG_OK); EQUALS(value, 1023);
+        r = librg_bitstream_read_bits(&stream, &value, 4); EQUALS(r, LIBRG_READ_INVALID);
+
+        r = librg_bitstream_init(&stream, buffer, 16); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_write_bits(&stream, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_write_bits(&stream, 0xDEADBEEFCAFEBABEull, 64); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_bitstream_size(&stream), 9);
+
+        r = librg_bitstream_init(&stream, buffer, 16); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_read_bits(&stream, &value, 1); EQUALS(value, 1);
+        r = librg_bitstream_read_bits(&stream, &value, 64); r = value == 0xDEADBEEFCAFEBABEull; EQUALS(r, LIBRG_TRUE);
+    });
+
+    IT("should write and read bounded ints and quantized floats", {
+        char buffer[16] = {0};
+        librg_bitstream stream = {0};
+        int64_t value = 0;
+        float fvalue = 0;
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_write_int(&stream, -3, -10, 10); EQUALS(r, LIBRG_OK);
+        r = librg_bitstream_write_int(&stream, 100, -10, 10); EQUALS(r, LIBRG_OK); /* clamped */
+        EQUALS(stream.position, 10);
+        r = librg_bitstream_write_float(&stream, 12.345f, -1024.0f, 1024.0f, 0.01f); EQUALS(r, LIBRG_OK);
+        EQUALS(stream.position, 28);
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_read_int(&stream, &value, -10, 10); EQUALS(r, LIBRG_OK); EQUALS(value, -3);
+        r = librg_bitstream_read_int(&stream, &value, -10, 10); EQUALS(r, LIBRG_OK); EQUALS(value, 10);
+        r = librg_bitstream_read_float(&stream, &fvalue, -1024.0f, 1024.0f, 0.01f); EQUALS(r, LIBRG_OK);
+        r = zpl_abs(fvalue - 12.345f) <= 0.01f; EQUALS(r, LIBRG_TRUE);
+    });
+
+    IT("should write and read smallest three quaternions", {
+        char buffer[16] = {0};
+        librg_bitstream stream = {0};
+        float input[4] = {0};
+        float output[4] = {0};
+        input[1] = -0.7071068f; input[3] = -0.7071068f;
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_write_quat(&stream, input, 10); EQUALS(r, LIBRG_OK);
+        EQUALS(stream.position, 32);
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_read_quat(&stream, output, 10); EQUALS(r, LIBRG_OK);
+
+        /* q and -q are the same rotation */
+        float dot = 0;
+        for (int i = 0; i < 4; ++i) dot += input[i] * output[i];
+        r = zpl_abs(dot) > 0.999f; EQUALS(r, LIBRG_TRUE);
+    });
+
+    IT("should write and read deltas against previous values", {
+        char buffer[16] = {0};
+        librg_bitstream stream = {0};
+        int64_t value = 0;
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_write_delta(&stream, 500, 500, 4, 16); EQUALS(r, LIBRG_OK);
+        EQUALS(stream.position, 1);
+        r = librg_bitstream_write_delta(&stream, 497, 500, 4, 16); EQUALS(r, LIBRG_OK);
+        EQUALS(stream.position, 7);
+        r = librg_bitstream_write_delta(&stream, -9000, 500, 4, 16); EQUALS(r, LIBRG_OK);
+        EQUALS(stream.position, 25);
+        r = librg_bitstream_write_delta(&stream, 90000, 500, 4, 16); EQUALS(r, LIBRG_WRITE_REJECT);
+        EQUALS(stream.position, 25);
+
+        librg_bitstream_init(&stream, buffer, 16);
+        r = librg_bitstream_read_delta(&stream, &value, 500, 4, 16); EQUALS(r, LIBRG_OK); EQUALS(value, 500);
+        r = librg_bitstream_read_delta(&stream, &value, 500, 4, 16); EQUALS(r, LIBRG_OK); EQUALS(value, 497);
+        r = librg_bitstream_read_delta(&stream, &value, 500, 4, 16); EQUALS(r, LIBRG_OK); EQUALS(value, -9000);
+    });
+
+    IT("should be bound to event buffers", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, bitstream_position_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_CREATE, bitstream_position_read); EQUALS(r, LIBRG_OK);
+
+        char buffer[256] = {0};
+        size_t buffer_size = 256;
+
+        bitstream_position[0] = 100.5f; bitstream_position[1] = -20.25f; bitstream_position[2] = 0.0f;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+
+        /* 3 x 18 bits, instead of 12 bytes */
+        size_t expected = CREATE_SEGMENT(1, 7) + OWNER_SEGMENT(1); EQUALS(buffer_size, expected);
+
+        bitstream_position[0] = 0; bitstream_position[1] = 0; bitstream_position[2] = 0;
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = zpl_abs(bitstream_position[0] - 100.5f) <= 0.01f; EQUALS(r, LIBRG_TRUE);
+        r = zpl_abs(bitstream_position[1] + 20.25f) <= 0.01f; EQUALS(r, LIBRG_TRUE);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+});
@@ -0,0 +1,177 @@
+static int compression_codec_calls = 0;
+
+/* drops trailing zeros, and inverts the rest, to make sure data is actually restored by the decoder */
+int32_t compression_trim_encode(const char *input, size_t input_size, char *output, size_t output_limit, const char *dictionary, size_t dictionary_size) {
+    zpl_unused(dictionary);
+    zpl_unused(dictionary_size);
+    compression_codec_calls++;
+
+    size_t size = input_size;
+    while (size > 0 && input[size - 1] == 0) size--;
+    if (size > output_limit) return LIBRG_WRITE_REJECT;
+    for (size_t i = 0; i < size; ++i) output[i] = (char)~input[i];
+
+    return (int32_t)size;
+}
+
+int32_t compression_trim_decode(const char *input, size_t input_size, char *output, size_t output_limit, const char *dictionary, size_t dictionary_size) {
+    zpl_unused(dictionary);
+    zpl_unused(dictionary_size);
+    compression_codec_calls++;
+
+    if (input_size > output_limit) return LIBRG_READ_INVALID;
+    for (size_t i = 0; i < input_size; ++i) output[i] = (char)~input[i];
+    for (size_t i = input_size; i < output_limit; ++i) output[i] = 0;
+
+    return (int32_t)output_limit;
+}
+
+int32_t compression_zero_write(librg_world *world, librg_event *event) {
+    char *buffer = librg_event_buffer_get(world, event);
+    memset(buffer, 0, 16);
+    return 16;
+}
+
+MODULE(compression, {
+    int8_t r = -1;
+
+    IT("should compress and decompress data with the built-in codec", {
+        char input[512] = {0};
+        char encoded[600] = {0};
+        char decoded[512] = {0};
+
+        for (int i = 0; i < 512; ++i) input[i] = (char)((i % 64) < 32 ? i % 7 : 'a');
+
+        int32_t size = librg_compression_lz_encode(input, 512, encoded, 600, NULL, 0);
+        GREATER(size, 0); LESSER(size, 128);
+
+        int32_t restored = librg_compression_lz_decode(encoded, size, decoded, 512, NULL, 0);
+        EQUALS(restored, 512);
+        r = memcmp(input, decoded, 512) == 0; EQUALS(r, LIBRG_TRUE);
+
+        /* not enough space */
+        r = librg_compression_lz_encode(input, 512, encoded, 4, NULL, 0) < 0; EQUALS(r, LIBRG_TRUE);
+
+        /* corrupted data */
+        r = librg_compression_lz_decode(encoded, size - 1, decoded, 512, NULL, 0) < 0; EQUALS(r, LIBRG_TRUE);
+        r = librg_compression_lz_decode(encoded, size, decoded, 100, NULL, 0) < 0; EQUALS(r, LIBRG_TRUE);
+    });
+
+    IT("should train and use a dictionary", {
+        const char *samples[4] = {0};
+        size_t sizes[4] = {0};
+        char dictionary[64] = {0};
+
+        samples[0] = "position:0001;rotation:0001;health:100;";
+        samples[1] = "position:0002;rotation:0003;health:090;";
+        samples[2] = "position:0009;rotation:0004;health:080;";
+        samples[3] = "position:0012;rotation:0005;health:070;";
+        for (int i = 0; i < 4; ++i) sizes[i] = strlen(samples[i]);
+
+        int32_t dictionary_size = librg_compression_dictionary_train(samples, sizes, 4, dictionary, 64);
+        GREATER(dictionary_size, 0);
+
+        const char *input = "position:0042;rotation:0042;health:042;";
+        size_t input_size = strlen(input);
+        char encoded[128] = {0};
+        char decoded[128] = {0};
+
+        int32_t plain = librg_compression_lz_encode(input, input_size, encoded, 128, NULL, 0);
+        int32_t trained = librg_compression_lz_encode(input, input_size, encoded, 128, dictionary, dictionary_size);
+        LESSER(trained, plain);
+
+        int32_t restored = librg_compression_lz_decode(encoded, trained, decoded, 128, dictionary, dictionary_size);
+        r = restored == (int32_t)input_size && memcmp(input, decoded, input_size) == 0; EQUALS(r, LIBRG_TRUE);
+    });
+
+    IT("should compress world buffers and report stats", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_compression_get(world1); EQUALS(r, LIBRG_FALSE);
+        r = librg_config_compression_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_compression_get(world1); EQUALS(r, LIBRG_TRUE);
+
+        for (int i = 1; i <= 32; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, compression_zero_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_CREATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        size_t buffer_size = 4096;
+
+        dummy_counter = 0;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        size_t expected = CREATE_SEGMENT(32, 16) + OWNER_SEGMENT(1); LESSER(buffer_size, expected / 4);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 32);
+        r = librg_entity_tracked(world2, 32); EQUALS(r, LIBRG_TRUE);
+
+        librg_compression_stats stats = {0};
+        r = librg_world_compression_stats(world1, &stats); EQUALS(r, LIBRG_OK);
+        EQUALS(stats.frames, 1);
+        EQUALS(stats.raw_bytes, expected);
+        EQUALS(stats.compressed_bytes, buffer_size);
+        r = stats.ratio < 0.25f && stats.compress_time >= 0; EQUALS(r, LIBRG_TRUE);
+
+        r = librg_world_compression_stats(world2, &stats); EQUALS(r, LIBRG_OK);
+        r = stats.decompress_time >= 0 && stats.frames == 0; EQUALS(r, LIBRG_TRUE);
+
+        /* corrupted frame */
+        r = librg_world_read(world2, 1, buffer, buffer_size - 1, NULL); EQUALS(r, LIBRG_READ_INVALID);
+
+        /* frame claiming a huge original size is rejected before allocating */
+        char frame[6] = {0};
+        frame[0] = (char)0xFE; frame[4] = 0x7F;
+        for (int i = 1; i < 4; ++i) frame[i] = (char)0xFF;
+        r = librg_world_read(world2, 1, frame, 6, NULL); EQUALS(r, LIBRG_READ_INVALID);
+        LESSER(zpl_array_capacity(((librg_world_t *)world2)->compression_scratch), LIBRG_COMPRESSION_MAXSIZE + 1);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should use a custom codec", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_compression_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_compression_codec_set(world1, compression_trim_encode, compression_trim_decode); EQUALS(r, LIBRG_OK);
+        r = librg_config_compression_codec_set(world2, compression_trim_encode, compression_trim_decode); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, compression_zero_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        size_t buffer_size = 4096;
+
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 1); EQUALS(r, LIBRG_TRUE);
+
+        /* update with trailing zeros is shrunk by our codec */
+        compression_codec_calls = 0;
+        dummy_counter = 0;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(compression_codec_calls, 1);
+        size_t expected = UPDATE_SEGMENT(1, 16); LESSER(buffer_size, expected);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(compression_codec_calls, 2);
+        EQUALS(dummy_counter, 1);
+        dummy_counter = 0;
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+});
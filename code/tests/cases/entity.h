@@ -107,4 +107,214 @@ MODULE(entity, {
 
         librg_world_destroy(world);
     });
+
+    IT("should track, move and untrack entities in bulk", {
+        librg_world *world = librg_world_create();
+        int64_t ids[100] = {0};
+        librg_chunk chunks[100] = {0};
+        int32_t amount = 0;
+
+        for (int i = 0; i < 100; ++i) { ids[i] = i + 1; chunks[i] = i % 7; }
+
+        r = librg_entity_track(world, 5); EQUALS(r, LIBRG_OK);
+        amount = librg_entity_track_many(world, ids, 100); EQUALS(amount, 99); /* 5 is already tracked */
+        EQUALS(librg_entity_count(world), 100);
+        r = librg_entity_owner_get(world, 50); EQUALS(r, LIBRG_OWNER_INVALID);
+
+        amount = librg_entity_chunk_set_many(world, ids, chunks, 100); EQUALS(amount, 100);
+        EQUALS(librg_entity_chunk_get(world, 13), 5);
+
+        /* out of order, repeated and unknown ids */
+        int64_t mixed[6] = {0};
+        librg_chunk mixed_chunks[6] = {0};
+        mixed[0] = 5; mixed[1] = 70; mixed[2] = 71; mixed[3] = 3; mixed[4] = 1000; mixed[5] = 70;
+        for (int i = 0; i < 6; ++i) mixed_chunks[i] = 11 + i;
+        amount = librg_entity_chunk_set_many(world, mixed, mixed_chunks, 6); EQUALS(amount, 5);
+        EQUALS(librg_entity_chunk_get(world, 5), 11);
+        EQUALS(librg_entity_chunk_get(world, 70), 16);
+        EQUALS(librg_entity_chunk_get(world, 71), 13);
+        EQUALS(librg_entity_chunk_get(world, 3), 14);
+        EQUALS(librg_entity_chunk_get(world, 4), 3);
+        amount = librg_entity_chunk_set_many(world, ids, chunks, 100); EQUALS(amount, 100);
+
+        /* owner storage is freed once all of its entities are gone */
+        r = librg_entity_owner_set(world, 10, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 20, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 30, 2); EQUALS(r, LIBRG_OK);
+
+        amount = librg_entity_untrack_many(world, ids + 9, 15); EQUALS(amount, 15); /* 10..24 */
+        EQUALS(librg_entity_count(world), 85);
+        r = librg_entity_tracked(world, 9); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_tracked(world, 20); EQUALS(r, LIBRG_FALSE);
+        r = librg_entity_tracked(world, 25); EQUALS(r, LIBRG_TRUE);
+        EQUALS(librg_entity_chunk_get(world, 27), 5);
+
+        char buffer[1024] = {0}; size_t buffer_size = 1024;
+        r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_OWNER_INVALID);
+        buffer_size = 1024;
+        r = librg_world_write(world, 2, 0, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_OK);
+
+        amount = librg_entity_untrack_many(world, ids, 100); EQUALS(amount, 85);
+        EQUALS(librg_entity_count(world), 0);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should size the entity storage once for the tracked entities", {
+        general_allocator_t counters = {0};
+        librg_allocator allocator = {0};
+        allocator.alloc = general_alloc;
+        allocator.realloc = general_realloc;
+        allocator.free = general_free;
+        allocator.userdata = &counters;
+
+        librg_world *world = librg_world_create_ex(&allocator);
+        int64_t ids[1000] = {0};
+        for (int i = 0; i < 1000; ++i) ids[i] = i;
+
+        /* hashes and entries */
+        int64_t allocs = counters.allocs + counters.reallocs;
+        r = librg_entity_track_many(world, ids, 1000) == 1000; EQUALS(r, 1);
+        LESSER(counters.allocs + counters.reallocs - allocs, 5);
+
+        librg_world_destroy(world);
+        EQUALS(counters.allocs, counters.frees);
+    });
+
+    IT("should place entities into chunks covered by the bounding box", {
+        librg_world *world = librg_world_create();
+        librg_config_chunkamount_set(world, 16, 16, 16);
+        librg_entity_track(world, 15);
+
+        double min[3] = {0};
+        double max[3] = {0};
+        librg_chunk res[8] = {0}; size_t amt = 8;
+        librg_chunk center = librg_chunk_from_realpos(world, 1, 1, 1);
+        librg_chunk right = librg_chunk_from_realpos(world, 20, 1, 1);
+
+        min[0] = 1; min[1] = 1; min[2] = 1; max[0] = 5; max[1] = 5; max[2] = 5;
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, LIBRG_OK);
+        librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 1); EQUALS(res[0], center);
+
+        /* spans two chunks, moving within them keeps the same coverage */
+        max[0] = 20; amt = 8;
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, LIBRG_OK);
+        librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 2); EQUALS(res[0], center); EQUALS(res[1], right);
+
+        min[0] = 2; max[0] = 21; amt = 8;
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, LIBRG_OK);
+        librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 2); EQUALS(res[1], right);
+
+        /* manual placement resets the cached coverage */
+        r = librg_entity_chunk_set(world, 15, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, LIBRG_OK);
+        amt = 8; librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 2); EQUALS(res[0], center);
+
+        /* 13x13 chunks do not fit, center chunk is kept */
+        min[0] = -100; min[1] = -100; max[0] = 100; max[1] = 100; max[2] = 1; amt = 8;
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, 127);
+        librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 8); EQUALS(res[0], librg_chunk_from_realpos(world, 0, 0, 1));
+
+        /* outside of the world */
+        min[0] = 1000; max[0] = 1001; amt = 8;
+        r = librg_entity_aabb_set(world, 15, min, max); EQUALS(r, LIBRG_OK);
+        librg_entity_chunkarray_get(world, 15, res, &amt);
+        EQUALS(amt, 0);
+
+        r = librg_entity_aabb_set(world, 16, min, max); EQUALS(r, LIBRG_ENTITY_UNTRACKED);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should access entities through generation checked handles", {
+        librg_world *world = librg_world_create();
+        librg_entity_handle h1 = LIBRG_HANDLE_INVALID;
+        librg_entity_handle h2 = LIBRG_HANDLE_INVALID;
+        librg_entity_handle h3 = LIBRG_HANDLE_INVALID;
+        int64_t ids[3] = {0};
+
+        r = librg_entity_track_handle(world, 1, &h1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track_handle(world, 2, &h2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track_handle(world, 2, &h3); EQUALS(r, LIBRG_ENTITY_ALREADY_TRACKED);
+        r = h3 == LIBRG_HANDLE_INVALID; EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_track(world, 3); EQUALS(r, LIBRG_OK);
+
+        /* existing ids get their handle on request, and keep it */
+        h3 = librg_entity_handle_get(world, 3);
+        r = h3 != LIBRG_HANDLE_INVALID && h3 == librg_entity_handle_get(world, 3); EQUALS(r, LIBRG_TRUE);
+        EQUALS(librg_entity_handle_id(world, h3), 3);
+
+        r = librg_entity_handle_chunk_set(world, h2, 5); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_chunk_get(world, 2), 5);
+        r = librg_entity_handle_userdata_set(world, h3, world); EQUALS(r, LIBRG_OK);
+        r = librg_entity_handle_userdata_get(world, h3) == world; EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_owner_set(world, 3, 7); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_handle_owner_get(world, h3), 7);
+        r = librg_entity_handle_dirty_set(world, h3); EQUALS(r, LIBRG_OK);
+
+        /* removal of an entity shifts others, handles still point to the right ones */
+        r = librg_entity_untrack(world, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_handle_valid(world, h1); EQUALS(r, LIBRG_FALSE);
+        r = librg_entity_handle_chunk_set(world, h1, 1); EQUALS(r, LIBRG_ENTITY_UNTRACKED);
+        EQUALS(librg_entity_handle_id(world, h2), 2);
+        EQUALS(librg_entity_handle_chunk_get(world, h2), 5);
+        r = librg_entity_handle_userdata_get(world, h3) == world; EQUALS(r, LIBRG_TRUE);
+
+        /* released slot is reused with a new generation */
+        librg_entity_handle h4 = LIBRG_HANDLE_INVALID;
+        r = librg_entity_track_handle(world, 1, &h4); EQUALS(r, LIBRG_OK);
+        r = h4 != h1 && (h4 & 0xFFFFFFFF) == (h1 & 0xFFFFFFFF); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_handle_valid(world, h1); EQUALS(r, LIBRG_FALSE);
+
+        ids[0] = 2; ids[1] = 1;
+        r = librg_entity_untrack_many(world, ids, 2); EQUALS(r, 2);
+        r = librg_entity_handle_valid(world, h2) || librg_entity_handle_valid(world, h4); EQUALS(r, LIBRG_FALSE);
+        EQUALS(librg_entity_handle_id(world, h3), 3);
+        EQUALS(librg_entity_handle_owner_get(world, h3), 7);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should keep per-owner visibility overrides inline, and move them to a table when there are many", {
+        librg_world *world = librg_world_create();
+        librg_world_t *wld = (librg_world_t *)world;
+        librg_entity_track(world, 15);
+        librg_entity_t *entity = librg_table_ent_get(&wld->entity_map, 15);
+
+        r = librg_entity_visibility_owner_get(world, 15, 1); EQUALS(r, LIBRG_VISIBLITY_DEFAULT);
+
+        for (int i = 1; i <= LIBRG_ENTITY_VISIBILITY_INLINE; ++i) {
+            r = librg_entity_visibility_owner_set(world, 15, i, i % 2 ? LIBRG_VISIBLITY_NEVER : LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+        }
+
+        EQUALS(entity->owner_visibility_count, LIBRG_ENTITY_VISIBILITY_INLINE);
+        r = librg_entity_visibility_owner_set(world, 15, 1, LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_owner_set(world, 15, 2, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+        EQUALS(entity->owner_visibility_count, LIBRG_ENTITY_VISIBILITY_INLINE);
+        r = librg_entity_visibility_owner_get(world, 15, 1); EQUALS(r, LIBRG_VISIBLITY_ALWAYS);
+        r = librg_entity_visibility_owner_get(world, 15, 2); EQUALS(r, LIBRG_VISIBLITY_NEVER);
+        r = librg_entity_visibility_owner_get(world, 15, 42); EQUALS(r, LIBRG_VISIBLITY_DEFAULT);
+
+        /* spills over */
+        r = librg_entity_visibility_owner_set(world, 15, 42, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+        EQUALS(entity->owner_visibility_count, LIBRG_VISIBILITY_SPILLED);
+        r = librg_entity_visibility_owner_get(world, 15, 42); EQUALS(r, LIBRG_VISIBLITY_NEVER);
+        r = librg_entity_visibility_owner_get(world, 15, 1); EQUALS(r, LIBRG_VISIBLITY_ALWAYS);
+        r = librg_entity_visibility_owner_get(world, 15, 2); EQUALS(r, LIBRG_VISIBLITY_NEVER);
+        r = librg_entity_visibility_owner_get(world, 15, 7); EQUALS(r, LIBRG_VISIBLITY_DEFAULT);
+
+        r = librg_entity_untrack(world, 15); EQUALS(r, LIBRG_OK);
+        librg_world_destroy(world);
+    });
+
+    IT("should keep inline visibility overrides within the entity size", {
+        /* inline owners share the space with the hash table, and their values fill the padding */
+        r = sizeof(((librg_entity_t *)0)->owner_visibility) == LIBRG_MAX(sizeof(librg_table_i8), LIBRG_ENTITY_VISIBILITY_INLINE * sizeof(int64_t)); EQUALS(r, LIBRG_TRUE);
+        if (sizeof(void *) == 8 && LIBRG_ENTITY_VISIBILITY_INLINE == 4) { r = sizeof(librg_entity_t) <= 192; EQUALS(r, LIBRG_TRUE); }
+    });
 });
@@ -1,3 +1,31 @@
+typedef struct general_allocator_t {
+    int64_t allocs;
+    int64_t reallocs;
+    int64_t frees;
+} general_allocator_t;
+
+void *general_alloc(void *userdata, size_t size) {
+    ((general_allocator_t *)userdata)->allocs++;
+    return malloc(size);
+}
+
+void *general_realloc(void *userdata, void *ptr, size_t old_size, size_t new_size) {
+    zpl_unused(old_size);
+    ((general_allocator_t *)userdata)->reallocs++;
+    return realloc(ptr, new_size);
+}
+
+void *general_realloc_fail(void *userdata, void *ptr, size_t old_size, size_t new_size) {
+    zpl_unused(ptr); zpl_unused(old_size); zpl_unused(new_size);
+    ((general_allocator_t *)userdata)->reallocs++;
+    return NULL;
+}
+
+void general_free(void *userdata, void *ptr) {
+    ((general_allocator_t *)userdata)->frees++;
+    free(ptr);
+}
+
 MODULE(general, {
     int8_t r = -1;
 
@@ -8,6 +36,134 @@ MODULE(general, {
         EQUALS(r, LIBRG_OK);
     });
 
+    IT("should route allocations of a world into a custom allocator", {
+        general_allocator_t counters = {0};
+        librg_allocator allocator = {0};
+        allocator.alloc = general_alloc;
+        allocator.realloc = general_realloc;
+        allocator.free = general_free;
+        allocator.userdata = &counters;
+
+        librg_world *world = librg_world_create_ex(&allocator);
+        NEQUALS(world, NULL);
+
+        for (int i = 0; i < 256; ++i) {
+            librg_entity_track(world, i);
+            librg_entity_chunk_set(world, i, 1);
+        }
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+
+        /* scratch buffer of the compression is grown via realloc */
+        r = librg_config_compression_set(world, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        char buffer[8192] = {0};
+        size_t buffer_size = 8192;
+        r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+
+        r = librg_world_destroy(world); EQUALS(r, LIBRG_OK);
+        GREATER(counters.allocs, 1);
+        GREATER(counters.reallocs, 0);
+        EQUALS(counters.allocs, counters.frees);
+
+        /* without realloc, resizes are done via alloc-copy-free */
+        zpl_zero_item(&counters);
+        allocator.realloc = NULL;
+
+        world = librg_world_create_ex(&allocator);
+        for (int i = 0; i < 256; ++i) librg_entity_track(world, i);
+        r = librg_world_destroy(world); EQUALS(r, LIBRG_OK);
+        EQUALS(counters.reallocs, 0);
+        EQUALS(counters.allocs, counters.frees);
+    });
+
+    IT("should leave the buffer uncompressed, if the scratch can not be grown", {
+        general_allocator_t counters = {0};
+        librg_allocator allocator = {0};
+        allocator.alloc = general_alloc;
+        allocator.realloc = general_realloc_fail;
+        allocator.free = general_free;
+        allocator.userdata = &counters;
+
+        librg_world *world1 = librg_world_create_ex(&allocator);
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 0; i < 256; ++i) {
+            librg_entity_track(world1, i); librg_entity_chunk_set(world1, i, 1);
+            librg_entity_track(world2, i); librg_entity_chunk_set(world2, i, 1);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world2, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_config_compression_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_compression_set(world2, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        char buffer1[8192] = {0};
+        char buffer2[8192] = {0};
+        size_t buffer_size1 = 8192;
+        size_t buffer_size2 = 8192;
+        r = librg_world_write(world1, 1, 0, buffer1, &buffer_size1, NULL); EQUALS(r, 0);
+        r = librg_world_write(world2, 1, 0, buffer2, &buffer_size2, NULL); EQUALS(r, 0);
+
+        /* same write is compressed with the default allocator */
+        GREATER(counters.reallocs, 0);
+        GREATER(buffer_size1, buffer_size2);
+
+        librg_world *world3 = librg_world_create();
+        r = librg_world_read(world3, 1, buffer1, buffer_size1, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_count(world3), 256);
+        librg_world_destroy(world3);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+        EQUALS(counters.allocs, counters.frees);
+    });
+
+    IT("should not allocate on repeated writes of the same world", {
+        general_allocator_t counters = {0};
+        librg_allocator allocator = {0};
+        allocator.alloc = general_alloc;
+        allocator.realloc = general_realloc;
+        allocator.free = general_free;
+        allocator.userdata = &counters;
+
+        librg_world *world = librg_world_create_ex(&allocator);
+
+        for (int i = 0; i < 64; ++i) {
+            librg_entity_track(world, i);
+            librg_entity_chunk_set(world, i, i % 4);
+        }
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_config_prioritization_set(world, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        char buffer[8192] = {0};
+        size_t buffer_size = 8192;
+        int64_t allocs = 0;
+
+        for (int i = 0; i < 8; ++i) {
+            /* first iterations size up the tables and scratch buffers */
+            if (i == 2) allocs = counters.allocs + counters.reallocs;
+
+            buffer_size = 8192;
+            r = librg_world_write(world, 1, 2, buffer, &buffer_size, NULL); EQUALS(r, 0);
+
+            /* abandoned resumable write */
+            buffer_size = 64;
+            r = librg_world_write_begin(world, 1, 2, NULL); EQUALS(r, LIBRG_OK);
+            r = librg_world_write_next(world, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_TRUE);
+            r = librg_world_write_begin(world, 1, 2, NULL); EQUALS(r, LIBRG_OK);
+
+            buffer_size = 8192;
+            r = librg_world_write_next(world, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE);
+        }
+
+        EQUALS(counters.allocs + counters.reallocs, allocs);
+
+        r = librg_world_destroy(world); EQUALS(r, LIBRG_OK);
+        EQUALS(counters.allocs, counters.frees);
+    });
+
     IT("should be return proper check for is valid", {
         librg_world *world = librg_world_create();
         EQUALS(librg_world_valid(world), 1);
@@ -369,4 +525,101 @@ MODULE(general, {
         r = librg_chunk_to_chunkpos(world, 0, &x, &y, &z); EQUALS(r, LIBRG_OK); EQUALS(x, -2); EQUALS(y, -2); EQUALS(z, -2);
         r = librg_chunk_to_chunkpos(world, 63, &x, &y, &z); EQUALS(r, LIBRG_OK); EQUALS(x, 1); EQUALS(y, 1); EQUALS(z, 1);
     });
+
+    IT("should reserve capacity so tables do not rehash while filling up", {
+        librg_world *world = librg_world_create();
+        librg_world_t *wld = (librg_world_t *)world;
+
+        r = librg_world_reserve(world, 256, 4, 256); EQUALS(r, LIBRG_OK);
+        zpl_isize *entity_hashes = wld->entity_map.hashes;
+        zpl_isize *owner_hashes = wld->owner_map.hashes;
+
+        for (int i = 0; i < 256; ++i) {
+            librg_entity_track(world, i);
+            librg_entity_chunk_set(world, i, 1);
+        }
+
+        for (int i = 0; i < 4; ++i) librg_entity_owner_set(world, i, i + 1);
+        r = entity_hashes == wld->entity_map.hashes && owner_hashes == wld->owner_map.hashes; EQUALS(r, LIBRG_TRUE);
+
+        /* snapshot tables are reused between writes */
+        char buffer[8192] = {0};
+        size_t buffer_size = 8192;
+        librg_owner_t *owner = librg_table_own_get(&wld->owner_map, 1);
+        EQUALS(zpl_array_count(owner->snapshot.hashes), 342);
+
+        zpl_isize *snapshot_hashes = owner->snapshot.hashes;
+        zpl_isize *spare_hashes = owner->spare.hashes;
+        r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = owner->snapshot.hashes == spare_hashes && owner->spare.hashes == snapshot_hashes; EQUALS(r, LIBRG_TRUE);
+        buffer_size = 8192; r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = owner->snapshot.hashes == snapshot_hashes && owner->spare.hashes == spare_hashes; EQUALS(r, LIBRG_TRUE);
+        EQUALS(zpl_array_count(owner->snapshot.entries), 256);
+
+        /* ownership pairs and per-query chunk sets do not grow either */
+        GREATER(zpl_array_capacity(wld->owner_entity_pairs), 255);
+        zpl_isize *dimension_hashes = wld->dimensions.entries[0].value.hashes;
+        buffer_size = 8192; r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = dimension_hashes == wld->dimensions.entries[0].value.hashes; EQUALS(r, LIBRG_TRUE);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should report memory usage of the world internals", {
+        librg_world *world = librg_world_create();
+        librg_memory_stats stats = {0};
+
+        r = librg_world_memory_stats(world, &stats); EQUALS(r, LIBRG_OK);
+        EQUALS(stats.entities.count, 0);
+        GREATER(stats.total.bytes, sizeof(librg_world_t) - 1);
+
+        for (int i = 0; i < 64; ++i) {
+            librg_entity_track(world, i);
+            librg_entity_chunk_set(world, i, 1);
+        }
+
+        librg_entity_owner_set(world, 0, 1);
+        librg_entity_owner_set(world, 1, 2);
+        for (int i = 0; i < 8; ++i) librg_entity_visibility_owner_set(world, 2, 10 + i, LIBRG_VISIBLITY_NEVER);
+
+        char buffer[4096] = {0};
+        size_t buffer_size = 4096;
+        r = librg_world_write(world, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+
+        r = librg_world_memory_stats(world, &stats); EQUALS(r, LIBRG_OK);
+        EQUALS(stats.entities.count, 64);
+        EQUALS(stats.owners.count, 2);
+        EQUALS(stats.pairs.count, 2);
+        EQUALS(stats.visibility.count, 8);
+        EQUALS(stats.largest_snapshot.count, 64);
+        GREATER(stats.snapshots.count, 62);
+        GREATER(stats.entities.bytes, 64 * sizeof(librg_entity_t) - 1);
+        GREATER(stats.total.bytes, stats.entities.bytes + stats.snapshots.bytes);
+
+        /* sampled maximums are kept, once the structures shrink */
+        uint64_t entities_bytes = stats.entities.bytes;
+        for (int i = 2; i < 64; ++i) librg_entity_untrack(world, i);
+        librg_entity_owner_set(world, 0, 2);
+
+        for (int i = 1; i <= 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world, i, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        }
+
+        r = librg_world_memory_stats(world, &stats); EQUALS(r, LIBRG_OK);
+        EQUALS(stats.entities.count, 2);
+        EQUALS(stats.entities.sampled_max_count, 64);
+        EQUALS(stats.entities.sampled_max_bytes, entities_bytes);
+        EQUALS(stats.visibility.count, 0);
+        EQUALS(stats.largest_snapshot.count, 2);
+        EQUALS(stats.largest_snapshot.sampled_max_count, 64);
+
+        /* growth in between the calls is not sampled */
+        for (int i = 100; i < 200; ++i) librg_entity_track(world, i);
+        for (int i = 100; i < 200; ++i) librg_entity_untrack(world, i);
+        r = librg_world_memory_stats(world, &stats); EQUALS(r, LIBRG_OK);
+        EQUALS(stats.entities.sampled_max_count, 64);
+
+        librg_world_destroy(world);
+    });
 });
@@ -36,6 +36,78 @@ int32_t dummy_markuserdata(librg_world *w, librg_event *e) {
     return 0;
 }
 
+static int dummy_counter = 0;
+
+int32_t dummy_2bytes_counted(librg_world *world, librg_event *event) {
+    dummy_counter++;
+    return dummy_2bytes(world, event);
+}
+
+static char dummy_payload[32] = {0};
+static char dummy_received[32] = {0};
+static int32_t dummy_received_size = 0;
+
+int32_t dummy_payload_write(librg_world *world, librg_event *event) {
+    char *buffer = librg_event_buffer_get(world, event);
+    if (librg_event_size_get(world, event) < (int32_t)sizeof(dummy_payload)) return LIBRG_WRITE_REJECT;
+    memcpy(buffer, dummy_payload, sizeof(dummy_payload));
+    return sizeof(dummy_payload);
+}
+
+int32_t dummy_payload_read(librg_world *world, librg_event *event) {
+    dummy_received_size = librg_event_size_get(world, event);
+    memcpy(dummy_received, librg_event_buffer_get(world, event), LIBRG_MIN(sizeof(dummy_received), (size_t)dummy_received_size));
+    return 0;
+}
+
+static int dummy_batch_calls = 0;
+
+/* writes id of each entity, except the third one */
+int32_t dummy_batch_write(librg_world *world, librg_event_batch *batch) {
+    zpl_unused(world);
+    dummy_batch_calls++;
+
+    for (size_t i = 0; i < batch->amount; ++i) {
+        if (batch->entity_ids[i] == 3) { batch->sizes[i] = LIBRG_WRITE_REJECT; continue; }
+        *(int32_t *)batch->buffers[i] = (int32_t)batch->entity_ids[i];
+        batch->sizes[i] = sizeof(int32_t);
+    }
+
+    return LIBRG_OK;
+}
+
+int32_t dummy_batch_read(librg_world *world, librg_event *event) {
+    int32_t value = 0;
+    memcpy(&value, librg_event_buffer_get(world, event), sizeof(value));
+    if (value == librg_event_entity_get(world, event)) dummy_counter++;
+    return 0;
+}
+
+static int64_t dummy_batch_ids[16] = {0};
+static size_t dummy_batch_amount = 0;
+
+/* checks that each payload contains the id of its entity, and that entity is still tracked */
+int32_t dummy_batch_read_all(librg_world *world, librg_event_batch *batch) {
+    dummy_batch_calls++;
+    dummy_batch_amount = batch->amount;
+
+    for (size_t i = 0; i < batch->amount; ++i) {
+        int32_t id = 0;
+        dummy_batch_ids[i] = batch->entity_ids[i];
+        if (batch->sizes[i] == 4) memcpy(&id, batch->buffers[i], sizeof(id));
+        if (batch->sizes[i] == 4 && id == batch->entity_ids[i]
+            && librg_entity_tracked(world, batch->entity_ids[i]) == LIBRG_TRUE) dummy_counter++;
+    }
+
+    return LIBRG_OK;
+}
+
+int32_t dummy_id_write(librg_world *world, librg_event *event) {
+    int32_t id = (int32_t)librg_event_entity_get(world, event);
+    memcpy(librg_event_buffer_get(world, event), &id, sizeof(id));
+    return sizeof(int32_t);
+}
+
 /* helper macro to print a segment */
 #define SEGMENT_PRINT(buf, amt) \
     for(size_t i=0;i<amt;i++) printf("%02x ",buf[i]); \
@@ -731,6 +803,17 @@ MODULE(packing, {
 
         EQUALS(value, 1); /* value == 1 means the LIBRG_ERROR_CREATE call was indeed executed */
 
+        /* repeated creation of a foreign entity is an error as well, unless the writer uses acknowledgements */
+        r = librg_entity_track(world1, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 2, 1); EQUALS(r, LIBRG_OK);
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        value = 0;
+        r = librg_world_read(world2, 1, buffer, buffer_size, &value); EQUALS(r, LIBRG_OK);
+        EQUALS(value, 1);
+
         r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
         r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
     });
@@ -1095,4 +1178,1119 @@ MODULE(packing, {
         r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
         r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
     });
+
+    // =======================================================================//
+    // !
+    // ! Write all
+    // !
+    // =======================================================================//
+
+    IT("should write all owners in one call, same as writing each one", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 6; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_track(world2, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, i < 4 ? 1 : 5); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world2, i, i < 4 ? 1 : 5); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 4, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world2, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world2, 4, 2); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+
+        int64_t owners[3]; owners[0] = 1; owners[1] = 2; owners[2] = 3;
+        char buffer1[512] = {0}; char buffer2[512] = {0}; char buffer3[512] = {0};
+        char *buffers[3]; buffers[0] = buffer1; buffers[1] = buffer2; buffers[2] = buffer3;
+        size_t sizes[3]; sizes[0] = 512; sizes[1] = 512; sizes[2] = 512;
+        int32_t results[3] = {0};
+
+        r = librg_world_write_all(world1, owners, 3, 0, buffers, sizes, results, NULL); EQUALS(r, 0);
+
+        EQUALS(results[0], 0);
+        EQUALS(results[1], 0);
+        EQUALS(results[2], LIBRG_OWNER_INVALID);
+        EQUALS(sizes[2], 0);
+
+        for (int i = 0; i < 2; ++i) {
+            char buffer[512] = {0};
+            buffer_size = 512;
+            r = librg_world_write(world2, owners[i], 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(sizes[i], buffer_size);
+            size_t expected = CREATE_SEGMENT(3, 2) + OWNER_SEGMENT(1); EQUALS(buffer_size, expected);
+        }
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should write all owners same as writing each one, with entities spanning several chunks", {
+        librg_world *worlds[2]; worlds[0] = librg_world_create(); worlds[1] = librg_world_create();
+
+        for (int w = 0; w < 2; ++w) {
+            r = librg_config_chunkamount_set(worlds[w], 8, 8, 1); EQUALS(r, LIBRG_OK);
+
+            for (int i = 1; i <= 16; ++i) {
+                /* chunk positions are centered around the world origin */
+                int16_t x = (int16_t)((i * 3) % 8 - 4);
+                int16_t y = (int16_t)((i * 5) % 8 - 4);
+                librg_chunk chunks[3];
+                chunks[0] = librg_chunk_from_chunkpos(worlds[w], x, y, 0);
+                chunks[1] = librg_chunk_from_chunkpos(worlds[w], (int16_t)((x + 5) % 8 - 4), y, 0);
+                chunks[2] = librg_chunk_from_chunkpos(worlds[w], x, (int16_t)((y + 5) % 8 - 4), 0);
+
+                r = librg_entity_track(worlds[w], i); EQUALS(r, LIBRG_OK);
+                r = librg_entity_chunkarray_set(worlds[w], i, chunks, 3); EQUALS(r, LIBRG_OK);
+            }
+
+            /* owned entities are not set in the order of their ids */
+            r = librg_entity_owner_set(worlds[w], 9, 2); EQUALS(r, LIBRG_OK);
+            r = librg_entity_owner_set(worlds[w], 12, 1); EQUALS(r, LIBRG_OK);
+            r = librg_entity_owner_set(worlds[w], 6, 3); EQUALS(r, LIBRG_OK);
+            r = librg_entity_owner_set(worlds[w], 3, 1); EQUALS(r, LIBRG_OK);
+
+            r = librg_entity_visibility_owner_set(worlds[w], 7, 3, LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+            r = librg_entity_visibility_global_set(worlds[w], 8, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+            r = librg_event_set(worlds[w], LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        }
+
+        /* ownership tokens are random, so both worlds have to share them */
+        for (int i = 1; i <= 16; ++i) {
+            librg_entity_t *entity1 = librg_table_ent_get(&((librg_world_t *)worlds[0])->entity_map, i);
+            librg_entity_t *entity2 = librg_table_ent_get(&((librg_world_t *)worlds[1])->entity_map, i);
+            entity2->ownership_token = entity1->ownership_token;
+        }
+
+        /* entities overlapping several of the visible chunks are included once */
+        int64_t results[32] = {0};
+        size_t amount = 32;
+        r = librg_world_query(worlds[1], 1, 1, results, &amount); EQUALS(r, 0);
+        GREATER(amount, 2);
+
+        int duplicates = 0;
+        for (size_t i = 0; i < amount; ++i)
+            for (size_t j = i + 1; j < amount; ++j)
+                duplicates += results[i] == results[j];
+        EQUALS(duplicates, 0);
+
+        int64_t owners[3]; owners[0] = 1; owners[1] = 2; owners[2] = 3;
+        char buffer1[1024] = {0}; char buffer2[1024] = {0}; char buffer3[1024] = {0};
+        char *buffers[3]; buffers[0] = buffer1; buffers[1] = buffer2; buffers[2] = buffer3;
+        size_t sizes[3]; sizes[0] = 1024; sizes[1] = 1024; sizes[2] = 1024;
+
+        r = librg_world_write_all(worlds[0], owners, 3, 1, buffers, sizes, NULL, NULL); EQUALS(r, 0);
+
+        for (int i = 0; i < 3; ++i) {
+            char buffer[1024] = {0};
+            buffer_size = 1024;
+            r = librg_world_write(worlds[1], owners[i], 1, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(sizes[i], buffer_size);
+            EQUALS(zpl_memcompare(buffers[i], buffer, buffer_size), 0);
+        }
+
+        r = librg_world_destroy(worlds[0]); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(worlds[1]); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should report insufficient buffer size per owner when writing all", {
+        librg_world *world = librg_world_create();
+
+        r = librg_entity_track(world, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world, 3); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_chunk_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 2, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 3, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 2, 2); EQUALS(r, LIBRG_OK);
+
+        int64_t owners[2]; owners[0] = 1; owners[1] = 2;
+        char buffer1[4096] = {0}; char buffer2[4096] = {0};
+        char *buffers[2]; buffers[0] = buffer1; buffers[1] = buffer2;
+        size_t sizes[2]; sizes[0] = 4096; sizes[1] = 30;
+        int32_t results[2] = {0};
+
+        r = librg_world_write_all(world, owners, 2, 0, buffers, sizes, results, NULL); EQUALS(r, 1);
+
+        EQUALS(results[0], 0);
+        GREATER(results[1], 0);
+        size_t expected = CREATE_SEGMENT(3, 0) + OWNER_SEGMENT(1); EQUALS(sizes[0], expected);
+        expected = CREATE_SEGMENT(1, 0); EQUALS(sizes[1], expected);
+
+        r = librg_world_destroy(world); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Event cache
+    // !
+    // =======================================================================//
+
+    IT("should call cached update handler once per entity per tick", {
+        librg_world *world = librg_world_create();
+
+        r = librg_entity_track(world, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world, 3); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_chunk_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 2, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 3, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 2, 2); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world, LIBRG_WRITE_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+        r = librg_event_cache_set(world, LIBRG_WRITE_UPDATE, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_event_cache_get(world, LIBRG_WRITE_UPDATE); EQUALS(r, LIBRG_TRUE);
+        r = librg_event_cache_set(world, LIBRG_READ_UPDATE, LIBRG_TRUE); EQUALS(r, LIBRG_EVENT_INVALID);
+
+        int64_t owners[2]; owners[0] = 1; owners[1] = 2;
+        char buffer1[4096] = {0}; char buffer2[4096] = {0};
+        char *buffers[2]; buffers[0] = buffer1; buffers[1] = buffer2;
+        size_t sizes[2];
+
+        /* first tick creates, second and third ones update */
+        for (int tick = 0; tick < 3; ++tick) {
+            sizes[0] = 4096; sizes[1] = 4096;
+            r = librg_world_write_all(world, owners, 2, 0, buffers, sizes, NULL, NULL); EQUALS(r, 0);
+        }
+
+        EQUALS(dummy_counter, 6);
+        size_t expected = UPDATE_SEGMENT(3, 2);
+        EQUALS(sizes[0], expected);
+        EQUALS(sizes[1], expected);
+
+        /* manual writes share cache till the next tick */
+        dummy_counter = 0;
+        r = librg_world_tick(world); EQUALS(r, LIBRG_OK);
+        buffer_size = 4096; r = librg_world_write(world, 1, 0, buffer1, &buffer_size, NULL);
+        buffer_size = 4096; r = librg_world_write(world, 2, 0, buffer2, &buffer_size, NULL);
+        EQUALS(dummy_counter, 3);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Delta encoding
+    // !
+    // =======================================================================//
+
+    IT("should write delta encoded updates and restore them on read", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_deltaencoding_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_deltaencoding_get(world1); EQUALS(r, LIBRG_TRUE);
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world1, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 2, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_payload_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_payload_read); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        for (int i = 0; i < 32; ++i) dummy_payload[i] = (char)(i + 1);
+
+        /* create */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+
+        /* first update is sent in full */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        size_t full_size = buffer_size;
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_received_size, 32);
+        r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+
+        /* unchanged payload costs only a few bytes */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        LESSER(buffer_size, full_size);
+        size_t expected = UPDATE_SEGMENT(2, 4) + 1; EQUALS(buffer_size, expected); /* sequence, then distance + size + single skip run */
+        memset(dummy_received, 0, 32);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+
+        /* and changed bytes are properly restored */
+        dummy_payload[5] = 42; dummy_payload[31] = 0;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        LESSER(buffer_size, full_size);
+        memset(dummy_received, 0, 32);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_received_size, 32);
+        r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+
+        /* restored size larger than a segment value can carry is rejected before allocating */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer[buffer_size - 3], 0x20);
+        buffer[buffer_size - 3] = (char)0xFF; buffer[buffer_size - 2] = (char)0xFF; buffer[buffer_size - 1] = 0x7F;
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_READ_INVALID);
+        LESSER(zpl_array_capacity(((librg_world_t *)world2)->delta_scratch), 1024);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should not restore deltas against updates the reader has not received", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_deltaencoding_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        for (int i = 1; i <= 3; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_payload_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_payload_read); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_ERROR_UPDATE, dummy_markuserdata); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        int marked = 0;
+        for (int i = 0; i < 32; ++i) dummy_payload[i] = (char)(i + 1);
+
+        /* create, and the first full update */
+        for (int i = 0; i < 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+        }
+
+        /* abandoned resumable write is not referenced by the next one */
+        dummy_payload[0] = 7;
+        buffer_size = UPDATE_SEGMENT(1, 32) + 1;
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); printf("DBG %d %zu\n", r, buffer_size); EQUALS(r, LIBRG_TRUE);
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+
+        dummy_payload[1] = 7;
+        buffer_size = 4096;
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE);
+        memset(dummy_received, 0, 32);
+        r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+        r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+        EQUALS(marked, 0);
+
+        /* lost update can not be used to restore the next one */
+        dummy_payload[2] = 7;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+
+        dummy_payload[3] = 7;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        memset(dummy_received, 0, 32);
+        r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+        EQUALS(marked, 1);
+        EQUALS(dummy_received[3], 0);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should not delta encode updates written into the unreliable buffer without acknowledgements", {
+        librg_world *world1 = librg_world_create();
+
+        r = librg_config_deltaencoding_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_payload_write); EQUALS(r, LIBRG_OK);
+
+        char reliable[4096] = {0};
+        char unreliable[4096] = {0};
+        size_t reliable_size = 4096;
+        size_t unreliable_size = 4096;
+
+        for (int i = 0; i < 3; ++i) {
+            reliable_size = 4096;
+            unreliable_size = 4096;
+            r = librg_world_write_split(world1, 1, 0, reliable, &reliable_size, unreliable, &unreliable_size, NULL); EQUALS(r, 0);
+        }
+
+        EQUALS(unreliable_size, UPDATE_SEGMENT(1, 32));
+        r = unreliable[1]; EQUALS(r, 0);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+    });
+
+
+    // =======================================================================//
+    // !
+    // ! Compact wire format
+    // !
+    // =======================================================================//
+
+    IT("should write compact segments and read them back", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_wireformat_get(world1); EQUALS(r, LIBRG_WIREFORMAT_DEFAULT);
+        r = librg_config_wireformat_set(world1, LIBRG_WIREFORMAT_COMPACT); EQUALS(r, LIBRG_OK);
+        r = librg_config_wireformat_get(world1); EQUALS(r, LIBRG_WIREFORMAT_COMPACT);
+
+        r = librg_entity_track(world1, 3); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_track(world1, 2); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 2, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 3, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_CREATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+
+        /* create: 4 bytes of segment header, 3 entities with 2 bytes of headers each, and a token for the owned one */
+        dummy_counter = 0;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        size_t expected = CREATE_SEGMENT(3, 2) + OWNER_SEGMENT(1); LESSER(buffer_size, expected);
+        r = (uint8_t)buffer[0]; EQUALS(r, (0x80 | LIBRG_WRITE_CREATE));
+        r = buffer[3]; EQUALS(r, 13);
+
+        /* truncated buffers are not read */
+        r = librg_world_read(world2, 1, buffer, 3, NULL); GREATER(r, 0);
+        r = librg_world_read(world2, 1, buffer, 16, NULL); GREATER(r, 0);
+        EQUALS(dummy_counter, 0);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 3);
+        r = librg_entity_foreign(world2, 1); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_foreign(world2, 3); EQUALS(r, LIBRG_TRUE);
+        r = (int32_t)librg_entity_owner_get(world2, 1); EQUALS(r, 1);
+
+        /* update */
+        dummy_counter = 0;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        expected = UPDATE_SEGMENT(3, 2); LESSER(buffer_size, expected);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 3);
+
+        /* remove */
+        r = librg_entity_untrack(world1, 3); EQUALS(r, LIBRG_OK);
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 3); EQUALS(r, LIBRG_FALSE);
+        r = librg_entity_tracked(world2, 2); EQUALS(r, LIBRG_TRUE);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Prioritization
+    // !
+    // =======================================================================//
+
+    IT("should write most important entities first, and eventually write all of them", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+        float weight = 0;
+
+        r = librg_config_prioritization_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_prioritization_get(world1); EQUALS(r, LIBRG_TRUE);
+
+        for (int i = 1; i <= 6; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, librg_chunk_from_chunkpos(world1, 0, 0, 0)); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_priority_get(world1, 4, &weight); EQUALS(r, LIBRG_OK);
+        r = weight == 1.0f; EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_priority_set(world1, 6, 10.0f); EQUALS(r, LIBRG_OK);
+
+        /* distant entity is less important, than a near one with the same weight */
+        r = librg_entity_chunk_set(world1, 2, librg_chunk_from_chunkpos(world1, 1, 0, 0)); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+
+        /* buffer fits only 2 entities per write */
+        char buffer[4096] = {0};
+
+        buffer_size = CREATE_SEGMENT(2, 2);
+        r = librg_world_write(world1, 1, 1, buffer, &buffer_size, NULL); GREATER(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 6); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_tracked(world2, 1); EQUALS(r, LIBRG_TRUE);
+
+        buffer_size = CREATE_SEGMENT(2, 2);
+        r = librg_world_write(world1, 1, 1, buffer, &buffer_size, NULL); GREATER(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 3); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_tracked(world2, 4); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_tracked(world2, 2); EQUALS(r, LIBRG_FALSE);
+
+        buffer_size = CREATE_SEGMENT(2, 2);
+        r = librg_world_write(world1, 1, 1, buffer, &buffer_size, NULL);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 5); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_tracked(world2, 2); EQUALS(r, LIBRG_TRUE);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Fragmented writes
+    // !
+    // =======================================================================//
+
+    IT("should split a single write into self-contained fragments", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 10; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+
+        /* nothing was started yet */
+        buffer_size = 4096;
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE); EQUALS(buffer_size, 0);
+        r = librg_world_write_begin(world1, 42, 0, NULL); EQUALS(r, LIBRG_OWNER_INVALID);
+
+        /* last value of each fragment does not fit, and is carried over to the next one */
+        size_t mtu = CREATE_SEGMENT(3, 2) - 1;
+        int fragments = 0;
+        int32_t more = LIBRG_TRUE;
+        dummy_counter = 0;
+
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+
+        while (more == LIBRG_TRUE) {
+            buffer_size = mtu;
+            more = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL);
+            fragments++;
+            LESSER(buffer_size, mtu + 1); GREATER(buffer_size, 0);
+
+            r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        }
+
+        EQUALS(more, LIBRG_FALSE);
+        EQUALS(fragments, 6);
+        EQUALS(dummy_counter, 10);
+
+        for (int i = 1; i <= 10; ++i) {
+            r = librg_entity_tracked(world2, i); EQUALS(r, LIBRG_TRUE);
+        }
+
+        r = librg_entity_owner_get(world2, 1); EQUALS(r, 1);
+
+        /* snapshot was swapped once the whole tick was written, so next tick contains only updates */
+        dummy_counter = 0;
+        buffer_size = 4096;
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE);
+        EQUALS(buffer_size, UPDATE_SEGMENT(10, 0));
+        EQUALS(dummy_counter, 0);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should reject entities bigger than a fragment, and release unfinished writes", {
+        librg_world *world1 = librg_world_create();
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_payload_write); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        buffer_size = CREATE_SEGMENT(1, 2);
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE);
+        EQUALS(buffer_size, 0);
+
+        /* payload carried over into a smaller fragment does not fit, and the missing size is reported */
+        r = librg_entity_track(world1, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 2, 1); EQUALS(r, LIBRG_OK);
+
+        size_t insufficient = 0;
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        buffer_size = CREATE_SEGMENT(1, 32) + 20;
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, &insufficient); EQUALS(r, LIBRG_TRUE);
+        EQUALS(insufficient, 0);
+
+        buffer_size = CREATE_SEGMENT(1, 16);
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, &insufficient);
+        EQUALS(insufficient, 16);
+
+        /* abandoned write is cleaned up on restart and destruction */
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should write fragments into a chain of caller-supplied and pooled blocks", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 10; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+
+        char block[CREATE_SEGMENT(3, 2)] = {0};
+        librg_iovec blocks[4] = {0};
+        size_t amount = 4;
+
+        /* first block is ours, the rest are taken from the pool */
+        blocks[0].base = block; blocks[0].len = sizeof(block);
+        blocks[1].len = CREATE_SEGMENT(3, 2);
+        blocks[2].len = CREATE_SEGMENT(3, 2);
+
+        r = librg_world_write_iovec(world1, 1, 0, blocks, &amount, NULL, NULL); EQUALS(r, LIBRG_FALSE);
+        EQUALS(amount, 4);
+        r = blocks[0].base == block && blocks[1].base != NULL && blocks[3].base != NULL; EQUALS(r, LIBRG_TRUE);
+        EQUALS(blocks[0].len, CREATE_SEGMENT(3, 2));
+        EQUALS(blocks[3].len, CREATE_SEGMENT(1, 2) + OWNER_SEGMENT(1));
+
+        for (size_t i = 0; i < amount; ++i) {
+            r = librg_world_read(world2, 1, blocks[i].base, blocks[i].len, NULL); EQUALS(r, LIBRG_OK);
+        }
+
+        for (int i = 1; i <= 10; ++i) {
+            r = librg_entity_tracked(world2, i); EQUALS(r, LIBRG_TRUE);
+        }
+
+        /* not enough blocks, the rest can be received fragment by fragment */
+        for (int i = 11; i <= 20; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        char *pooled = blocks[1].base;
+        zpl_memset(blocks, 0, sizeof(blocks));
+        blocks[0].len = CREATE_SEGMENT(3, 2);
+        amount = 1;
+
+        r = librg_world_write_iovec(world1, 1, 0, blocks, &amount, NULL, NULL); EQUALS(r, LIBRG_TRUE);
+        EQUALS(amount, 1);
+        r = blocks[0].base != pooled; EQUALS(r, LIBRG_TRUE);
+
+        buffer_size = 4096;
+        char buffer[4096] = {0};
+        r = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL); EQUALS(r, LIBRG_FALSE);
+
+        /* entities are skipped, if the block is too small for any of them, and the missing size is reported */
+        size_t insufficient = 0;
+        zpl_memset(blocks, 0, sizeof(blocks));
+        blocks[0].len = CREATE_SEGMENT(1, 0) - 1;
+        amount = 1;
+
+        r = librg_world_write_iovec(world1, 1, 0, blocks, &amount, &insufficient, NULL); EQUALS(r, LIBRG_FALSE);
+        GREATER(insufficient, 0);
+
+        zpl_memset(blocks, 0, sizeof(blocks));
+        amount = 4;
+        r = librg_world_write_iovec(world1, 1, 0, blocks, &amount, &insufficient, NULL); EQUALS(r, LIBRG_FALSE);
+        EQUALS(insufficient, 0);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Batched events
+    // !
+    // =======================================================================//
+
+    IT("should call batch write handler once per segment", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 5; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_batch_set(world1, LIBRG_ERROR_CREATE, dummy_batch_write, 4); EQUALS(r, LIBRG_EVENT_INVALID);
+        r = librg_event_batch_set(world1, LIBRG_WRITE_CREATE, dummy_batch_write, 4); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK); /* batch takes precedence */
+        r = librg_event_set(world2, LIBRG_READ_CREATE, dummy_batch_read); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        buffer_size = 4096;
+        dummy_batch_calls = 0;
+        dummy_counter = 0;
+
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(dummy_batch_calls, 1);
+        EQUALS(buffer_size, CREATE_SEGMENT(4, 4) + OWNER_SEGMENT(1));
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 4);
+        r = librg_entity_tracked(world2, 3); EQUALS(r, LIBRG_FALSE);
+
+        /* batch is produced once, and consumed over multiple fragments */
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+        world2 = librg_world_create();
+        r = librg_event_set(world2, LIBRG_READ_CREATE, dummy_batch_read); EQUALS(r, LIBRG_OK);
+
+        for (int i = 6; i <= 10; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        dummy_batch_calls = 0;
+        dummy_counter = 0;
+        int32_t more = LIBRG_TRUE;
+
+        r = librg_world_write_begin(world1, 1, 0, NULL); EQUALS(r, LIBRG_OK);
+        while (more == LIBRG_TRUE) {
+            buffer_size = CREATE_SEGMENT(2, 4);
+            more = librg_world_write_next(world1, 1, buffer, &buffer_size, NULL);
+            r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        }
+
+        EQUALS(dummy_batch_calls, 1);
+        EQUALS(dummy_counter, 5);
+
+        r = librg_event_batch_remove(world1, LIBRG_WRITE_CREATE); EQUALS(r, LIBRG_OK);
+        r = librg_event_batch_remove(world1, LIBRG_WRITE_CREATE); EQUALS(r, LIBRG_HANDLER_EMPTY);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should deliver read segments to the batch handler at once", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 5; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_config_deltaencoding_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_id_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_id_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_REMOVE, dummy_id_write); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_batch_set(world2, LIBRG_READ_CREATE, dummy_batch_read_all, 0); EQUALS(r, LIBRG_OK);
+        r = librg_event_batch_set(world2, LIBRG_READ_UPDATE, dummy_batch_read_all, 0); EQUALS(r, LIBRG_OK);
+        r = librg_event_batch_set(world2, LIBRG_READ_REMOVE, dummy_batch_read_all, 0); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+
+        for (int step = 0; step < 3; ++step) {
+            /* last step removes the entity 5 */
+            if (step == 2) { r = librg_entity_untrack(world1, 5); EQUALS(r, LIBRG_OK); }
+
+            buffer_size = 4096;
+            dummy_batch_calls = 0;
+            dummy_counter = 0;
+
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+
+            /* create + owner, update (delta-encoded), update + remove */
+            int expected_calls = step == 2 ? 2 : 1;
+            EQUALS(dummy_batch_calls, expected_calls);
+            EQUALS(dummy_counter, 5);
+        }
+
+        EQUALS(dummy_batch_amount, 1);
+        EQUALS(dummy_batch_ids[0], 5);
+        r = librg_entity_tracked(world2, 5); EQUALS(r, LIBRG_FALSE);
+        r = librg_entity_tracked(world2, 4); EQUALS(r, LIBRG_TRUE);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Dirty tracking
+    // !
+    // =======================================================================//
+
+    IT("should skip updates of entities that have not changed", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_dirtytracking_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_dirtytracking_get(world1); EQUALS(r, LIBRG_TRUE);
+
+        for (int i = 1; i <= 3; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        dummy_counter = 0;
+
+        r = librg_entity_dirty_get(world1, 2, 1); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_dirty_get(world1, 2, 42); EQUALS(r, LIBRG_OWNER_INVALID);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_dirty_get(world1, 2, 1); EQUALS(r, LIBRG_FALSE);
+
+        /* nothing has changed since creation */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, 0);
+        EQUALS(dummy_counter, 0);
+
+        r = librg_entity_dirty_set(world1, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_dirty_set(world1, 42); EQUALS(r, LIBRG_ENTITY_UNTRACKED);
+        r = librg_entity_dirty_get(world1, 2, 1); EQUALS(r, LIBRG_TRUE);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, UPDATE_SEGMENT(1, 2));
+        EQUALS(dummy_counter, 1);
+
+        /* clean entities are still considered alive */
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, 0);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 3); EQUALS(r, LIBRG_TRUE);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Reliable and unreliable streams
+    // !
+    // =======================================================================//
+
+    IT("should write structural and update segments into separate buffers", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 3; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char reliable[4096] = {0};
+        char unreliable[4096] = {0};
+        size_t reliable_size = 4096;
+        size_t unreliable_size = 4096;
+
+        r = librg_world_write_split(world1, 1, 0, reliable, &reliable_size, unreliable, &unreliable_size, NULL); EQUALS(r, 0);
+        EQUALS(reliable_size, CREATE_SEGMENT(3, 2) + OWNER_SEGMENT(1));
+        EQUALS(unreliable_size, 0);
+        r = librg_world_read(world2, 1, reliable, reliable_size, NULL); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_untrack(world1, 3); EQUALS(r, LIBRG_OK);
+        reliable_size = 4096;
+        unreliable_size = 4096;
+        dummy_counter = 0;
+
+        r = librg_world_write_split(world1, 1, 0, reliable, &reliable_size, unreliable, &unreliable_size, NULL); EQUALS(r, 0);
+        EQUALS(reliable_size, REMOVE_SEGMENT(1, 0));
+        EQUALS(unreliable_size, UPDATE_SEGMENT(2, 2));
+
+        /* each buffer can be read on its own, in any order */
+        r = librg_world_read(world2, 1, unreliable, unreliable_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 2);
+        r = librg_world_read(world2, 1, reliable, reliable_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 3); EQUALS(r, LIBRG_FALSE);
+
+        /* limits are applied to each buffer separately */
+        reliable_size = 4096;
+        unreliable_size = UPDATE_SEGMENT(1, 2);
+
+        r = librg_world_write_split(world1, 1, 0, reliable, &reliable_size, unreliable, &unreliable_size, NULL); GREATER(r, 0);
+        EQUALS(reliable_size, 0);
+        EQUALS(unreliable_size, UPDATE_SEGMENT(1, 2));
+
+        r = librg_world_write_split(world1, 42, 0, reliable, &reliable_size, unreliable, &unreliable_size, NULL); EQUALS(r, LIBRG_OWNER_INVALID);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    // =======================================================================//
+    // !
+    // ! Acknowledgements
+    // !
+    // =======================================================================//
+
+    IT("should diff against the last acknowledged write", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_acknowledgement_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_acknowledgement_get(world1); EQUALS(r, LIBRG_TRUE);
+
+        for (int i = 1; i <= 2; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_CREATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+
+        char lost[4096] = {0};
+        char buffer[4096] = {0};
+        size_t lost_size = 4096;
+        int64_t sequence = 0;
+        dummy_counter = 0;
+
+        /* first write is lost, so the next one creates the entities again */
+        r = librg_world_write(world1, 1, 0, lost, &lost_size, NULL); EQUALS(r, 0);
+        sequence = librg_world_write_sequence_get(world1, 1); EQUALS(sequence, 1);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, CREATE_SEGMENT(2, 2) + OWNER_SEGMENT(1));
+        sequence = librg_world_write_sequence_get(world1, 1); EQUALS(sequence, 2);
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_ack(world1, 1, 2); EQUALS(r, LIBRG_TRUE);
+        r = librg_world_write_ack(world1, 1, 1); EQUALS(r, LIBRG_FALSE);
+        r = librg_world_write_ack(world1, 42, 1); EQUALS(r, LIBRG_OWNER_INVALID);
+
+        /* late arrival of the lost write is treated as a resend */
+        r = librg_world_read(world2, 1, lost, lost_size, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(dummy_counter, 4);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, UPDATE_SEGMENT(2, 2));
+
+        /* removal is sent till it is acknowledged */
+        r = librg_entity_untrack(world1, 2); EQUALS(r, LIBRG_OK);
+
+        for (int i = 0; i < 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(buffer_size, UPDATE_SEGMENT(1, 2) + REMOVE_SEGMENT(1, 0));
+        }
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 2); EQUALS(r, LIBRG_FALSE);
+        sequence = librg_world_write_sequence_get(world1, 1);
+        r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, UPDATE_SEGMENT(1, 2));
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should delta encode only against acknowledged writes", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_acknowledgement_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_deltaencoding_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_payload_write); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_READ_UPDATE, dummy_payload_read); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_ERROR_UPDATE, dummy_markuserdata); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        int marked = 0;
+        int64_t sequence = 0;
+        for (int i = 0; i < 32; ++i) dummy_payload[i] = (char)(i + 1);
+
+        /* create, and the first full update are received */
+        for (int i = 0; i < 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+            sequence = librg_world_write_sequence_get(world1, 1);
+            r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+        }
+
+        size_t full_size = buffer_size;
+
+        /* write is lost, so it is never acknowledged */
+        dummy_payload[0] = 7;
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        LESSER(buffer_size, full_size);
+
+        /* next ones are still restored against the acknowledged one */
+        for (int i = 0; i < 2; ++i) {
+            dummy_payload[1 + i] = 7;
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            LESSER(buffer_size, full_size);
+
+            memset(dummy_received, 0, 32);
+            r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+            r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+            sequence = librg_world_write_sequence_get(world1, 1);
+            r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+        }
+
+        EQUALS(marked, 0);
+
+        /* baselines too old to be kept by the reader are not referenced, and payload is sent in full */
+        for (int i = 0; i < LIBRG_WORLDWRITE_MAXBASELINES; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        }
+
+        GREATER(buffer_size, UPDATE_SEGMENT(1, 32));
+        memset(dummy_received, 0, 32);
+        r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+        r = memcmp(dummy_received, dummy_payload, 32); EQUALS(r, 0);
+        EQUALS(marked, 0);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should resend dirty updates and ownership changes until acknowledged", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_acknowledgement_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+        r = librg_config_dirtytracking_set(world1, LIBRG_TRUE); EQUALS(r, LIBRG_OK);
+
+        for (int i = 1; i <= 2; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_CREATE, dummy_2bytes); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world1, LIBRG_WRITE_UPDATE, dummy_2bytes_counted); EQUALS(r, LIBRG_OK);
+        r = librg_event_set(world2, LIBRG_ERROR_REMOVE, dummy_markuserdata); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        int marked = 0;
+        int64_t sequence = 0;
+        dummy_counter = 0;
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        sequence = librg_world_write_sequence_get(world1, 1);
+        r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+
+        /* changed entity is written, till the write is acknowledged */
+        r = librg_entity_dirty_set(world1, 2); EQUALS(r, LIBRG_OK);
+
+        for (int i = 1; i <= 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(buffer_size, UPDATE_SEGMENT(1, 2));
+            EQUALS(dummy_counter, i);
+            r = librg_entity_dirty_get(world1, 2, 1); EQUALS(r, LIBRG_TRUE);
+        }
+
+        sequence = librg_world_write_sequence_get(world1, 1);
+        r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+        r = librg_entity_dirty_get(world1, 2, 1); EQUALS(r, LIBRG_FALSE);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, 0);
+        EQUALS(dummy_counter, 2);
+
+        /* so is the change of the ownership */
+        r = librg_entity_owner_set(world1, 2, 1); EQUALS(r, LIBRG_OK);
+
+        for (int i = 0; i < 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(buffer_size, OWNER_SEGMENT(1));
+        }
+
+        r = librg_world_read(world2, 1, buffer, buffer_size, NULL); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_get(world2, 2); EQUALS(r, 1);
+        sequence = librg_world_write_sequence_get(world1, 1);
+        r = librg_world_write_ack(world1, 1, sequence); EQUALS(r, LIBRG_TRUE);
+
+        buffer_size = 4096;
+        r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+        EQUALS(buffer_size, 0);
+
+        /* repeated removal of an already removed entity is ignored */
+        r = librg_entity_untrack(world1, 2); EQUALS(r, LIBRG_OK);
+
+        for (int i = 0; i < 2; ++i) {
+            buffer_size = 4096;
+            r = librg_world_write(world1, 1, 0, buffer, &buffer_size, NULL); EQUALS(r, 0);
+            EQUALS(buffer_size, REMOVE_SEGMENT(1, 0));
+            r = librg_world_read(world2, 1, buffer, buffer_size, &marked); EQUALS(r, LIBRG_OK);
+            r = librg_entity_tracked(world2, 2); EQUALS(r, LIBRG_FALSE);
+        }
+
+        EQUALS(marked, 0);
+
+        dummy_counter = 0;
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
 });
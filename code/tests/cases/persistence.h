@@ -0,0 +1,175 @@
+static int8_t persistence_contains(int64_t *entity_ids, size_t amount, int64_t entity_id) {
+    for (size_t i = 0; i < amount; ++i) if (entity_ids[i] == entity_id) return LIBRG_TRUE;
+    return LIBRG_FALSE;
+}
+
+MODULE(persistence, {
+    int8_t r = -1;
+
+    IT("should save and load a world", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_config_chunkamount_set(world1, 16, 16, 16); EQUALS(r, LIBRG_OK);
+        r = librg_config_chunksize_set(world1, 8, 8, 8); EQUALS(r, LIBRG_OK);
+
+        for (int i = 1; i <= 64; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world1, i, librg_chunk_from_chunkpos(world1, i % 8, 0, 0)); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world1, 1, 10); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world1, 2, 20); EQUALS(r, LIBRG_OK);
+        r = librg_entity_dimension_set(world1, 3, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world1, 5, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_layers_set(world1, 6, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_range_set(world1, 7, 12); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_owner_set(world1, 8, 10, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_global_set(world1, 9, LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+        r = librg_world_interest_set(world1, 10, 1); EQUALS(r, LIBRG_OK);
+
+        /* spill the overrides of a single entity */
+        for (int i = 0; i < 8; ++i) {
+            r = librg_entity_visibility_owner_set(world1, 4, 100 + i, LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+        }
+
+        size_t size = 0;
+        r = librg_world_save(world1, NULL, &size); EQUALS(r, LIBRG_WRITE_REJECT);
+        GREATER(size, 64);
+
+        char *buffer = (char *)malloc(size);
+        size_t small = size - 1;
+        r = librg_world_save(world1, buffer, &small); EQUALS(r, LIBRG_WRITE_REJECT);
+        EQUALS(small, size);
+
+        size_t written = size;
+        r = librg_world_save(world1, buffer, &written); EQUALS(r, LIBRG_OK);
+        EQUALS(written, size);
+
+        r = librg_world_load(world2, buffer, written); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_count(world2), 64);
+
+        uint16_t chunksize = 0;
+        r = librg_config_chunksize_get(world2, &chunksize, NULL, NULL); EQUALS(r, LIBRG_OK);
+        EQUALS(chunksize, 8);
+        EQUALS(librg_entity_chunk_get(world2, 3), librg_entity_chunk_get(world1, 3));
+        EQUALS(librg_entity_owner_get(world2, 1), 10);
+        EQUALS(librg_entity_dimension_get(world2, 3), 2);
+        EQUALS(librg_entity_parent_get(world2, 5), 1);
+        EQUALS(librg_entity_visibility_range_get(world2, 7), 12);
+        EQUALS(librg_entity_visibility_owner_get(world2, 8, 10), LIBRG_VISIBLITY_NEVER);
+        EQUALS(librg_entity_visibility_owner_get(world2, 4, 107), LIBRG_VISIBLITY_ALWAYS);
+        EQUALS(librg_entity_visibility_global_get(world2, 9), LIBRG_VISIBLITY_ALWAYS);
+        EQUALS(librg_world_interest_get(world2, 10), 1);
+
+        uint64_t layers = 0;
+        r = librg_entity_layers_get(world2, 6, &layers); EQUALS(r, LIBRG_OK);
+        EQUALS(layers, 2);
+
+        /* both worlds should produce the same query results */
+        int64_t results1[128] = {0};
+        int64_t results2[128] = {0};
+        size_t amount1 = 128;
+        size_t amount2 = 128;
+
+        r = librg_world_query(world1, 10, 1, results1, &amount1); EQUALS(r, LIBRG_OK);
+        r = librg_world_query(world2, 10, 1, results2, &amount2); EQUALS(r, LIBRG_OK);
+        EQUALS(amount1, amount2);
+
+        for (size_t i = 0; i < amount1; ++i) {
+            r = persistence_contains(results2, amount2, results1[i]); EQUALS(r, LIBRG_TRUE);
+        }
+
+        r = persistence_contains(results2, amount2, 5); EQUALS(r, LIBRG_TRUE);
+        r = persistence_contains(results2, amount2, 8); EQUALS(r, LIBRG_FALSE);
+
+        /* only empty worlds can be loaded into */
+        r = librg_world_load(world2, buffer, written); EQUALS(r, LIBRG_ENTITY_ALREADY_TRACKED);
+
+        free(buffer);
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should reject invalid buffers", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        r = librg_entity_track(world1, 1); EQUALS(r, LIBRG_OK);
+
+        char buffer[1024] = {0};
+        size_t size = 1024;
+        r = librg_world_save(world1, buffer, &size); EQUALS(r, LIBRG_OK);
+
+        /* truncated */
+        r = librg_world_load(world2, buffer, 8); EQUALS(r, LIBRG_READ_INVALID);
+        r = librg_world_load(world2, buffer, size - 1); EQUALS(r, LIBRG_READ_INVALID);
+
+        /* corrupted magic */
+        buffer[0] ^= 0x55;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        EQUALS(librg_entity_count(world2), 0);
+
+        buffer[0] ^= 0x55;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_OK);
+        r = librg_entity_tracked(world2, 1); EQUALS(r, LIBRG_TRUE);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+
+    IT("should reject attachment cycles and unknown visibility values", {
+        librg_world *world1 = librg_world_create();
+        librg_world *world2 = librg_world_create();
+
+        for (int i = 1; i <= 3; ++i) {
+            r = librg_entity_track(world1, i); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_attach(world1, 2, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world1, 3, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_owner_set(world1, 3, 10, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+
+        char buffer[4096] = {0};
+        size_t size = 4096;
+        r = librg_world_save(world1, buffer, &size); EQUALS(r, LIBRG_OK);
+
+        librg_persist_header_t header;
+        memcpy(&header, buffer, sizeof(header));
+        EQUALS(header.override_count, 1);
+
+        librg_persist_entity_t *records = (librg_persist_entity_t *)(buffer + header.entity_offset);
+        librg_persist_override_t *item = (librg_persist_override_t *)(buffer + header.override_offset);
+        librg_persist_entity_t *first = NULL;
+
+        for (uint64_t i = 0; i < header.entity_count; ++i)
+            if (records[i].id == 1) first = &records[i];
+
+        NEQUALS(first, NULL);
+
+        /* 1 -> 3 -> 2 -> 1, and 1 -> 1 */
+        first->parent_id = 3;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        first->parent_id = 1;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        first->parent_id = LIBRG_ENTITY_INVALID;
+
+        first->visibility_global = 3;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        first->visibility_global = LIBRG_VISIBLITY_DEFAULT;
+
+        item->value = 3;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        item->value = -1;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_READ_INVALID);
+        EQUALS(librg_entity_count(world2), 0);
+
+        item->value = LIBRG_VISIBLITY_NEVER;
+        r = librg_world_load(world2, buffer, size); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_parent_get(world2, 3), 2);
+        EQUALS(librg_entity_visibility_owner_get(world2, 3, 10), LIBRG_VISIBLITY_NEVER);
+
+        r = librg_world_destroy(world1); EQUALS(r, LIBRG_OK);
+        r = librg_world_destroy(world2); EQUALS(r, LIBRG_OK);
+    });
+});
@@ -1,3 +1,12 @@
+static int32_t query_written = 0;
+
+int32_t query_count_write(librg_world *world, librg_event *event) {
+    zpl_unused(world);
+    zpl_unused(event);
+    query_written++;
+    return 0;
+}
+
 MODULE(query, {
     int8_t r = -1;
 
@@ -698,4 +707,169 @@ MODULE(query, {
 
         librg_world_destroy(world);
     });
+
+    IT("should append attached entities right after their parent", {
+        librg_world *world = librg_world_create();
+
+        for (int i = 1; i <= 8; ++i) {
+            r = librg_entity_track(world, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world, i, i == 2 ? 100 : 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 8, 1); EQUALS(r, LIBRG_OK);
+
+        /* children chunks are ignored, they follow the parent (unless owned by the observer) */
+        r = librg_entity_attach(world, 3, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world, 8, 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world, 5, 4); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world, 6, 4); EQUALS(r, LIBRG_OK);
+        r = librg_entity_attach(world, 7, 6); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_global_set(world, 7, LIBRG_VISIBLITY_NEVER); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_parent_get(world, 7), 6);
+        EQUALS(librg_entity_parent_get(world, 4), LIBRG_ENTITY_INVALID);
+
+        /* no cycles */
+        r = librg_entity_attach(world, 4, 7); EQUALS(r, LIBRG_ENTITY_INVALID);
+        r = librg_entity_attach(world, 4, 4); EQUALS(r, LIBRG_ENTITY_INVALID);
+        r = librg_entity_attach(world, 4, 42); EQUALS(r, LIBRG_ENTITY_UNTRACKED);
+
+        int64_t results[16] = {0};
+        size_t amt = 16;
+        r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 6);
+        EQUALS(results[0], 1);
+        EQUALS(results[1], 8); /* owned child is included, even though its parent is not visible */
+        EQUALS(results[2], 4);
+        EQUALS(results[3], 5);
+        EQUALS(results[4], 6);
+        EQUALS(results[5], 7);
+
+        /* moving to another parent */
+        r = librg_entity_attach(world, 3, 4); EQUALS(r, LIBRG_OK);
+        amt = 16; r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 7);
+        EQUALS(results[6], 3);
+
+        /* owned child of a visible parent is included only once */
+        r = librg_entity_attach(world, 8, 4); EQUALS(r, LIBRG_OK);
+        amt = 16; r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 7);
+        r = librg_entity_attach(world, 8, 2); EQUALS(r, LIBRG_OK);
+
+        /* shared query index gives the same results */
+        char buffer[512] = {0};
+        char *buffers[1]; buffers[0] = buffer;
+        size_t sizes[1]; sizes[0] = 512;
+        int64_t owners[1]; owners[0] = 1;
+        query_written = 0;
+        r = librg_event_set(world, LIBRG_WRITE_CREATE, query_count_write); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_all(world, owners, 1, 0, buffers, sizes, NULL, NULL); EQUALS(r, 0);
+        EQUALS(query_written, 7);
+
+        /* untracking a parent frees its children */
+        r = librg_entity_detach(world, 8); EQUALS(r, LIBRG_OK);
+        r = librg_entity_untrack(world, 4); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_parent_get(world, 5), LIBRG_ENTITY_INVALID);
+        EQUALS(librg_entity_parent_get(world, 7), 6);
+        amt = 16; r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 6);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should include entities visible from further away than the observer radius", {
+        librg_world *world = librg_world_create();
+
+        for (int i = 1; i <= 5; ++i) {
+            r = librg_entity_track(world, i); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_chunk_set(world, 1, librg_chunk_from_chunkpos(world, 0, 0, 0)); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 2, librg_chunk_from_chunkpos(world, 5, 0, 0)); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 3, librg_chunk_from_chunkpos(world, 5, 0, 0)); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 4, librg_chunk_from_chunkpos(world, 20, 0, 0)); EQUALS(r, LIBRG_OK);
+        r = librg_entity_chunk_set(world, 5, librg_chunk_from_chunkpos(world, 4, 3, 0)); EQUALS(r, LIBRG_OK);
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+
+        r = librg_entity_visibility_range_set(world, 2, 6); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_range_set(world, 4, 6); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_range_set(world, 5, 4); EQUALS(r, LIBRG_OK);
+        EQUALS(librg_entity_visibility_range_get(world, 2), 6);
+        EQUALS(librg_entity_visibility_range_get(world, 3), 0);
+        r = librg_entity_visibility_range_set(world, 42, 6); EQUALS(r, LIBRG_ENTITY_UNTRACKED);
+
+        int64_t results[16] = {0};
+        size_t amt = 16;
+        r = librg_world_query(world, 1, 1, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 2);
+        EQUALS(results[0], 1);
+        EQUALS(results[1], 2);
+
+        /* observer radius still works for all entities */
+        amt = 16; r = librg_world_query(world, 1, 5, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 4);
+
+        /* same results via the shared query index */
+        char buffer[512] = {0};
+        char *buffers[1]; buffers[0] = buffer;
+        size_t sizes[1]; sizes[0] = 512;
+        int64_t owners[1]; owners[0] = 1;
+        query_written = 0;
+        r = librg_event_set(world, LIBRG_WRITE_CREATE, query_count_write); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_all(world, owners, 1, 1, buffers, sizes, NULL, NULL); EQUALS(r, 0);
+        EQUALS(query_written, 2);
+
+        librg_world_destroy(world);
+    });
+
+    IT("should filter entities by visibility layers of the owner interest", {
+        librg_world *world = librg_world_create();
+        uint64_t layers = 0;
+
+        for (int i = 1; i <= 5; ++i) {
+            r = librg_entity_track(world, i); EQUALS(r, LIBRG_OK);
+            r = librg_entity_chunk_set(world, i, 1); EQUALS(r, LIBRG_OK);
+        }
+
+        r = librg_entity_owner_set(world, 1, 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_layers_get(world, 2, &layers); EQUALS(r, LIBRG_OK);
+        r = layers == LIBRG_LAYERS_ALL; EQUALS(r, LIBRG_TRUE);
+
+        /* team a, team b, and an entity visible only for team a, via override */
+        r = librg_entity_layers_set(world, 2, 1 << 1); EQUALS(r, LIBRG_OK);
+        r = librg_entity_layers_set(world, 3, 1 << 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_layers_set(world, 4, 1 << 2); EQUALS(r, LIBRG_OK);
+        r = librg_entity_visibility_owner_set(world, 4, 1, LIBRG_VISIBLITY_ALWAYS); EQUALS(r, LIBRG_OK);
+        r = librg_entity_layers_set(world, 1, 0); EQUALS(r, LIBRG_OK);
+
+        r = librg_world_interest_set(world, 1, 1 << 1); EQUALS(r, LIBRG_OK);
+        r = librg_world_interest_get(world, 1) == (1 << 1); EQUALS(r, LIBRG_TRUE);
+        r = librg_world_interest_get(world, 2) == LIBRG_LAYERS_ALL; EQUALS(r, LIBRG_TRUE);
+
+        int64_t results[16] = {0};
+        size_t amt = 16;
+        r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 4);
+        EQUALS(results[0], 1);
+        EQUALS(results[1], 2);
+        EQUALS(results[2], 4);
+        EQUALS(results[3], 5);
+
+        /* same results via the shared query index */
+        char buffer[512] = {0};
+        char *buffers[1]; buffers[0] = buffer;
+        size_t sizes[1]; sizes[0] = 512;
+        int64_t owners[1]; owners[0] = 1;
+        query_written = 0;
+        r = librg_event_set(world, LIBRG_WRITE_CREATE, query_count_write); EQUALS(r, LIBRG_OK);
+        r = librg_world_write_all(world, owners, 1, 0, buffers, sizes, NULL, NULL); EQUALS(r, 0);
+        EQUALS(query_written, 4);
+
+        r = librg_world_interest_set(world, 1, LIBRG_LAYERS_ALL); EQUALS(r, LIBRG_OK);
+        amt = 16; r = librg_world_query(world, 1, 0, results, &amt); EQUALS(r, 0);
+        EQUALS(amt, 5);
+
+        librg_world_destroy(world);
+    });
 });
@@ -9,6 +9,9 @@
 #include "cases/entity.h"
 #include "cases/query.h"
 #include "cases/packing.h"
+#include "cases/bitstream.h"
+#include "cases/compression.h"
+#include "cases/persistence.h"
 
 int main() {
     UNIT_CREATE("librg");
@@ -17,6 +20,9 @@ int main() {
     UNIT_MODULE(entity);
     UNIT_MODULE(query);
     UNIT_MODULE(packing);
+    UNIT_MODULE(bitstream);
+    UNIT_MODULE(compression);
+    UNIT_MODULE(persistence);
 
     return UNIT_RUN();
 }